@@ -20,6 +20,7 @@
 #include "ha_sdb.h"
 #include <sql_class.h>
 #include <sql_table.h>
+#include <my_atomic.h>
 #include <mysql/plugin.h>
 #include <mysql/psi/mysql_file.h>
 #include <json_dom.h>
@@ -34,6 +35,8 @@
 #include "sdb_condition.h"
 #include "sdb_errcode.h"
 #include "sdb_idx.h"
+#include "sdb_stat.h"
+#include "sdb_i_s.h"
 
 using namespace sdbclient;
 
@@ -68,8 +71,19 @@ using namespace sdbclient;
 #define FLG_INSERT_REPLACEONDUP 0x00000004
 #endif
 
+#ifndef QUERY_PREPARE_MORE
+#define QUERY_PREPARE_MORE 0x00004000
+#endif
+
+#ifndef QUERY_PARALLED
+#define QUERY_PARALLED 0x00000100
+#endif
+
 #define SDB_OID_LEN 12
-#define SDB_OID_FIELD "_id"
+// the buffer of bulk insert larger than this is freed at the end of statement
+#define SDB_BULK_INSERT_BUF_KEEP_SIZE (1024 * 1024)
+// the batch of bulk insert is sent once its buffer exceeds this size
+#define SDB_BULK_INSERT_BUF_MAX_SIZE (16 * 1024 * 1024)
 #define SDB_FIELD_MAX_LEN (16 * 1024 * 1024)
 
 #define SDB_COMMENT "sequoiadb"
@@ -166,6 +180,22 @@ static int free_sdb_share(Sdb_share *share) {
   return 0;
 }
 
+void sdb_get_share_infos(std::vector<Sdb_share_info> &infos) {
+  mysql_mutex_lock(&sdb_mutex);
+  infos.reserve(sdb_open_tables.records);
+  for (ulong i = 0; i < sdb_open_tables.records; ++i) {
+    Sdb_share *share = (Sdb_share *)my_hash_element(&sdb_open_tables, i);
+    Sdb_share_info info;
+    info.table_name.assign(share->table_name, share->table_name_length);
+    info.use_count = share->use_count;
+    share->mutex.lock();
+    info.stat = share->stat;
+    share->mutex.unlock();
+    infos.push_back(info);
+  }
+  mysql_mutex_unlock(&sdb_mutex);
+}
+
 ha_sdb::ha_sdb(handlerton *hton, TABLE_SHARE *table_arg)
     : handler(hton, table_arg) {
   active_index = MAX_KEY;
@@ -178,6 +208,7 @@ ha_sdb::ha_sdb(handlerton *hton, TABLE_SHARE *table_arg)
   m_ignore_dup_key = false;
   m_write_can_replace = false;
   m_use_bulk_insert = false;
+  m_keyread = false;
   stats.records = 0;
   memset(db_name, 0, SDB_CS_NAME_MAX_SIZE + 1);
   memset(table_name, 0, SDB_CL_NAME_MAX_SIZE + 1);
@@ -208,7 +239,8 @@ const char **ha_sdb::bas_ext() const {
 ulonglong ha_sdb::table_flags() const {
   return (HA_REC_NOT_IN_SEQ | HA_NO_AUTO_INCREMENT | HA_NO_READ_LOCAL_LOCK |
           HA_BINLOG_ROW_CAPABLE | HA_BINLOG_STMT_CAPABLE |
-          HA_TABLE_SCAN_ON_INDEX | HA_NULL_IN_KEY | HA_CAN_INDEX_BLOBS);
+          HA_TABLE_SCAN_ON_INDEX | HA_NULL_IN_KEY | HA_CAN_INDEX_BLOBS |
+          HA_HAS_RECORDS);
 }
 
 ulong ha_sdb::index_flags(uint inx, uint part, bool all_parts) const {
@@ -315,6 +347,8 @@ int ha_sdb::close(void) {
     share = NULL;
   }
   m_bulk_insert_rows.clear();
+  m_bulk_insert_offsets.clear();
+  m_bulk_insert_buf.reset(SDB_BULK_INSERT_BUF_KEEP_SIZE);
   m_bson_element_cache.release();
   return 0;
 }
@@ -326,12 +360,15 @@ int ha_sdb::reset() {
   }
   // don't release bson element cache, so that we can reuse it
   m_bulk_insert_rows.clear();
+  m_bulk_insert_offsets.clear();
+  m_bulk_insert_buf.reset(SDB_BULK_INSERT_BUF_KEEP_SIZE);
   free_root(&blobroot, MYF(0));
   m_lock_type = TL_IGNORE;
   pushed_condition = SDB_EMPTY_BSON;
   m_ignore_dup_key = false;
   m_write_can_replace = false;
   m_use_bulk_insert = false;
+  m_keyread = false;
   return 0;
 }
 
@@ -341,6 +378,26 @@ int ha_sdb::row_to_obj(uchar *buf, bson::BSONObj &obj, bool gen_oid,
   bson::BSONObjBuilder obj_builder;
   bson::BSONObjBuilder null_obj_builder;
 
+  rc = row_to_builder(buf, obj_builder, gen_oid,
+                      output_null ? &null_obj_builder : NULL);
+  if (0 != rc) {
+    goto error;
+  }
+  obj = obj_builder.obj();
+  null_obj = null_obj_builder.obj();
+
+done:
+  return rc;
+error:
+  goto done;
+}
+
+// The null fields are output to null_obj_builder if it's not NULL.
+int ha_sdb::row_to_builder(uchar *buf, bson::BSONObjBuilder &obj_builder,
+                           bool gen_oid,
+                           bson::BSONObjBuilder *null_obj_builder) {
+  int rc = 0;
+
   my_bitmap_map *org_bitmap = dbug_tmp_use_all_columns(table, table->read_set);
   if (buf != table->record[0]) {
     repoint_field_to_record(table, table->record[0], buf);
@@ -354,8 +411,8 @@ int ha_sdb::row_to_obj(uchar *buf, bson::BSONObj &obj, bool gen_oid,
 
   for (Field **field = table->field; *field; field++) {
     if ((*field)->is_null()) {
-      if (output_null) {
-        null_obj_builder.append((*field)->field_name, "");
+      if (NULL != null_obj_builder) {
+        null_obj_builder->append((*field)->field_name, "");
       }
     } else {
       rc = field_to_obj(*field, obj_builder);
@@ -364,8 +421,6 @@ int ha_sdb::row_to_obj(uchar *buf, bson::BSONObj &obj, bool gen_oid,
       }
     }
   }
-  obj = obj_builder.obj();
-  null_obj = null_obj_builder.obj();
 
 done:
   if (buf != table->record[0]) {
@@ -677,6 +732,8 @@ void ha_sdb::start_bulk_insert(ha_rows rows) {
   }
 
   m_bulk_insert_rows.clear();
+  m_bulk_insert_offsets.clear();
+  m_bulk_insert_buf.reset();
 
   /**
     We don't bother with bulk-insert semantics when the estimated rows == 1
@@ -692,10 +749,17 @@ void ha_sdb::start_bulk_insert(ha_rows rows) {
 }
 
 int ha_sdb::flush_bulk_insert() {
-  DBUG_ASSERT(m_bulk_insert_rows.size() > 0);
+  DBUG_ASSERT(m_bulk_insert_offsets.size() > 0);
   DBUG_ASSERT(NULL != collection);
   DBUG_ASSERT(collection->thread_id() == ha_thd()->thread_id());
 
+  // the buffer doesn't move any more, so the records can refer to it
+  m_bulk_insert_rows.clear();
+  for (uint i = 0; i < m_bulk_insert_offsets.size(); ++i) {
+    m_bulk_insert_rows.push_back(
+        bson::BSONObj(m_bulk_insert_buf.buf() + m_bulk_insert_offsets[i]));
+  }
+
   int flag = 0;
   if (m_write_can_replace) {
     flag = FLG_INSERT_REPLACEONDUP;
@@ -712,6 +776,8 @@ int ha_sdb::flush_bulk_insert() {
   }
   stats.records += m_bulk_insert_rows.size();
   m_bulk_insert_rows.clear();
+  m_bulk_insert_offsets.clear();
+  m_bulk_insert_buf.reset();
   return rc;
 }
 
@@ -720,7 +786,7 @@ int ha_sdb::end_bulk_insert() {
 
   if (m_use_bulk_insert) {
     m_use_bulk_insert = false;
-    if (m_bulk_insert_rows.size() > 0) {
+    if (m_bulk_insert_offsets.size() > 0) {
       rc = flush_bulk_insert();
     }
   }
@@ -738,20 +804,38 @@ int ha_sdb::write_row(uchar *buf) {
   DBUG_ASSERT(NULL != collection);
   DBUG_ASSERT(collection->thread_id() == ha_thd()->thread_id());
 
-  rc = row_to_obj(buf, obj, TRUE, FALSE, tmp_obj);
-  if (rc != 0) {
-    goto error;
-  }
-
   if (m_use_bulk_insert) {
-    m_bulk_insert_rows.push_back(obj);
-    if ((int)m_bulk_insert_rows.size() >= sdb_bulk_insert_size) {
+    // Append the record to the buffer of batch directly, instead of
+    // allocating a buffer for each record.
+    int offset = m_bulk_insert_buf.len();
+    try {
+      bson::BSONObjBuilder obj_builder(m_bulk_insert_buf);
+      rc = row_to_builder(buf, obj_builder, TRUE, NULL);
+      obj_builder.done();
+    } catch (bson::assertion &e) {
+      SDB_LOG_ERROR("Exception[%s] occurs when build bson obj.",
+                    e.full.c_str());
+      rc = HA_ERR_OUT_OF_MEM;
+    }
+    if (rc != 0) {
+      // drop the incomplete record from the buffer
+      m_bulk_insert_buf.setlen(offset);
+      goto error;
+    }
+    m_bulk_insert_offsets.push_back(offset);
+    if ((int)m_bulk_insert_offsets.size() >= sdb_bulk_insert_size ||
+        m_bulk_insert_buf.len() >= SDB_BULK_INSERT_BUF_MAX_SIZE) {
       rc = flush_bulk_insert();
       if (rc != 0) {
         goto error;
       }
     }
   } else {
+    rc = row_to_obj(buf, obj, TRUE, FALSE, tmp_obj);
+    if (rc != 0) {
+      goto error;
+    }
+
     // TODO: SequoiaDB C++ driver currently has no insert() method with a flag,
     // we need send FLG_INSERT_CONTONDUP flag to server to ignore duplicate key
     // error, so that SequoiaDB will not rollback transaction, here we
@@ -972,6 +1056,7 @@ int ha_sdb::index_read_one(bson::BSONObj condition, int order_direction,
   int rc = 0;
   bson::BSONObj hint;
   bson::BSONObj order_by;
+  bson::BSONObj selector;
   int flag = 0;
   KEY *key_info = table->key_info + active_index;
 
@@ -989,16 +1074,25 @@ int ha_sdb::index_read_one(bson::BSONObj condition, int order_direction,
     goto error;
   }
 
+  // only the key fields are used in the index-only reads
+  if (m_keyread) {
+    rc = sdb_get_idx_selector(key_info, selector);
+    if (rc) {
+      SDB_LOG_ERROR("Fail to get index selector. rc: %d", rc);
+      goto error;
+    }
+  }
+
   flag = get_query_flag(thd_sql_command(ha_thd()), m_lock_type);
-  rc =
-      collection->query(condition, SDB_EMPTY_BSON, order_by, hint, 0, -1, flag);
+  trace_query("query", condition, selector, order_by, hint, 0, -1, flag);
+  rc = collection->query(condition, selector, order_by, hint, 0, -1, flag);
   if (rc) {
     SDB_LOG_ERROR(
         "Collection[%s.%s] failed to query with "
-        "condition[%s], order[%s], hint[%s]. rc: %d",
+        "condition[%s], selector[%s], order[%s], hint[%s]. rc: %d",
         collection->get_cs_name(), collection->get_cl_name(),
-        condition.toString().c_str(), order_by.toString().c_str(),
-        hint.toString().c_str(), rc);
+        condition.toString().c_str(), selector.toString().c_str(),
+        order_by.toString().c_str(), hint.toString().c_str(), rc);
     goto error;
   }
 
@@ -1066,6 +1160,13 @@ int ha_sdb::obj_to_row(bson::BSONObj &obj, uchar *buf) {
   my_bool is_select = (SQLCOM_SELECT == thd_sql_command(thd));
   memset(buf, 0, table->s->null_bytes);
 
+  /*
+    The blobs of previous row are not referenced after a new row is read,
+    as InnoDB and MyISAM also reuse their blob buffers. Keep the blocks so
+    that the memory is bounded by the largest row instead of the whole scan.
+  */
+  free_root(&blobroot, MYF(MY_MARK_BLOCKS_FREE));
+
   // allow zero date
   sql_mode_t old_sql_mode = thd->variables.sql_mode;
   thd->variables.sql_mode &= ~(MODE_NO_ZERO_DATE | MODE_NO_ZERO_IN_DATE);
@@ -1147,6 +1248,45 @@ error:
   goto done;
 }
 
+/*
+  Store the string without conversion if it's in the charset of field. The
+  blob refers to the value in the BSON of current record directly, which is
+  kept in cur_rec until next row is read, just like the blobs in blobroot.
+  VARCHAR is copied at once if its characters can't exceed the field.
+*/
+static bool sdb_store_str_directly(Field *field, const char *data, uint len,
+                                   const CHARSET_INFO *cs) {
+  bool stored = false;
+
+  if (!my_charset_same(field->charset(), cs)) {
+    goto done;
+  }
+
+  if (MYSQL_TYPE_BLOB == field->type()) {
+    Field_blob *blob = (Field_blob *)field;
+    if (len > blob->max_data_length()) {
+      goto done;
+    }
+    blob->set_ptr(len, (uchar *)data);
+    stored = true;
+  } else if (MYSQL_TYPE_VARCHAR == field->real_type()) {
+    Field_varstring *varstring = (Field_varstring *)field;
+    if (len > varstring->char_length()) {
+      goto done;
+    }
+    if (1 == varstring->length_bytes) {
+      *varstring->ptr = (uchar)len;
+    } else {
+      int2store(varstring->ptr, len);
+    }
+    memcpy(varstring->ptr + varstring->length_bytes, data, len);
+    stored = true;
+  }
+
+done:
+  return stored;
+}
+
 int ha_sdb::bson_element_to_field(const bson::BSONElement elem, Field *field) {
   int rc = SDB_ERR_OK;
 
@@ -1168,6 +1308,9 @@ int ha_sdb::bson_element_to_field(const bson::BSONElement elem, Field *field) {
       int lenTmp = 0;
       const char *dataTmp = elem.binData(lenTmp);
       if (MYSQL_TYPE_JSON != field->type()) {
+        if (sdb_store_str_directly(field, dataTmp, lenTmp, &my_charset_bin)) {
+          goto done;
+        }
         field->store(dataTmp, lenTmp, &my_charset_bin);
       } else {
         Field_json *field_json = dynamic_cast<Field_json *>(field);
@@ -1179,6 +1322,10 @@ int ha_sdb::bson_element_to_field(const bson::BSONElement elem, Field *field) {
     }
     case bson::String: {
       // datetime is stored as string
+      if (sdb_store_str_directly(field, elem.valuestr(),
+                                 elem.valuestrsize() - 1, &SDB_CHARSET)) {
+        goto done;
+      }
       field->store(elem.valuestr(), elem.valuestrsize() - 1, &SDB_CHARSET);
       break;
     }
@@ -1313,8 +1460,16 @@ int ha_sdb::rnd_next(uchar *buf) {
 
   if (first_read) {
     int flag = get_query_flag(thd_sql_command(ha_thd()), m_lock_type);
-    rc = collection->query(pushed_condition, SDB_EMPTY_BSON, SDB_EMPTY_BSON,
-                           SDB_EMPTY_BSON, 0, -1, flag);
+    bson::BSONObj order_by;
+    longlong limit = get_scan_limit(ha_thd(), order_by);
+    // the records of sub-collections are interleaved in the parallel scan
+    if (order_by.isEmpty() && sdb_parallel_scan(ha_thd())) {
+      flag |= QUERY_PARALLED;
+    }
+    trace_query("query", pushed_condition, SDB_EMPTY_BSON, order_by,
+                SDB_EMPTY_BSON, 0, limit, flag);
+    rc = collection->query(pushed_condition, SDB_EMPTY_BSON, order_by,
+                           SDB_EMPTY_BSON, 0, limit, flag);
     if (rc != 0) {
       goto error;
     }
@@ -1348,6 +1503,8 @@ int ha_sdb::rnd_pos(uchar *buf, uchar *pos) {
   objBuilder.appendOID(SDB_OID_FIELD, &oid);
   bson::BSONObj oidObj = objBuilder.obj();
 
+  trace_query("query_one", oidObj, SDB_EMPTY_BSON, SDB_EMPTY_BSON,
+              SDB_EMPTY_BSON, 0, 1, QUERY_WITH_RETURNDATA);
   rc = collection->query_one(cur_rec, oidObj);
   if (rc) {
     goto error;
@@ -1404,6 +1561,33 @@ error:
   goto done;
 }
 
+/*
+  Count the records of the collection on SequoiaDB, so that COUNT(*) costs
+  a single request instead of fetching every record. The server only calls
+  it for COUNT(*) without WHERE, when pushed_condition may be left by an
+  earlier scan, so it's not used.
+*/
+int ha_sdb::records(ha_rows *num_rows) {
+  int rc = 0;
+  long long count = 0;
+
+  DBUG_ASSERT(NULL != collection);
+  DBUG_ASSERT(collection->thread_id() == ha_thd()->thread_id());
+
+  rc = collection->get_count(count, SDB_EMPTY_BSON, SDB_EMPTY_BSON);
+  if (rc != 0) {
+    goto error;
+  }
+  *num_rows = (ha_rows)count;
+  stats.records = *num_rows;
+
+done:
+  return rc;
+error:
+  *num_rows = HA_POS_ERROR;
+  goto done;
+}
+
 int ha_sdb::update_stats(THD *thd, bool do_read_stat) {
   Sdb_statistics stat;
   int rc = 0;
@@ -1433,6 +1617,7 @@ int ha_sdb::update_stats(THD *thd, bool do_read_stat) {
     if (0 != rc) {
       goto done;
     }
+    sdb_stat_inc(thd->thread_id(), SDB_STAT_STATS_REFRESHES);
 
     /* Update shared statistics with fresh data */
     if (share) {
@@ -1474,6 +1659,12 @@ int ha_sdb::extra(enum ha_extra_function operation) {
     case HA_EXTRA_WRITE_CANNOT_REPLACE:
       m_write_can_replace = false;
       break;
+    case HA_EXTRA_KEYREAD:
+      m_keyread = true;
+      break;
+    case HA_EXTRA_NO_KEYREAD:
+      m_keyread = false;
+      break;
     default:
       break;
   }
@@ -1576,13 +1767,13 @@ int ha_sdb::external_lock(THD *thd, int lock_type) {
   thd_sdb = thd_get_thd_sdb(thd);
 
   if (F_UNLCK != lock_type) {
-    rc = start_statement(thd, thd_sdb->lock_count++);
+    rc = start_statement(thd, my_atomic_add32(&thd_sdb->lock_count, 1));
     if (0 != rc) {
-      thd_sdb->lock_count--;
+      my_atomic_add32(&thd_sdb->lock_count, -1);
       goto error;
     }
   } else {
-    if (!--thd_sdb->lock_count) {
+    if (1 == my_atomic_add32(&thd_sdb->lock_count, -1)) {
       if (!(thd_test_options(thd, OPTION_NOT_AUTOCOMMIT | OPTION_BEGIN)) &&
           thd_sdb->get_conn()->is_transaction_on()) {
         /*
@@ -1613,9 +1804,9 @@ int ha_sdb::start_stmt(THD *thd, thr_lock_type lock_type) {
   Thd_sdb *thd_sdb = thd_get_thd_sdb(thd);
 
   m_lock_type = lock_type;
-  rc = start_statement(thd, thd_sdb->start_stmt_count++);
+  rc = start_statement(thd, my_atomic_add32(&thd_sdb->start_stmt_count, 1));
   if (0 != rc) {
-    thd_sdb->start_stmt_count--;
+    my_atomic_add32(&thd_sdb->start_stmt_count, -1);
   }
 
   return rc;
@@ -2206,12 +2397,139 @@ int ha_sdb::get_query_flag(const uint sql_command,
       TL_READ_WITH_SHARED_LOCKS == lock_type) {
     query_flag |= QUERY_FOR_UPDATE;
   }
+  /*
+    Let SequoiaDB prepare the next batch while current batch is being read,
+    so that the fetching of next batch doesn't wait for the data nodes.
+  */
+  if (sdb_prefetch(ha_thd())) {
+    query_flag |= QUERY_PREPARE_MORE;
+  }
   return query_flag;
 }
 
+/*
+  Whether the order of field on SequoiaDB is the same as MySQL. Strings are
+  compared by collation in MySQL, and binary data by length first in BSON.
+*/
+static bool sdb_is_sortable_field(Field *field) {
+  switch (field->type()) {
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_LONG:
+    case MYSQL_TYPE_LONGLONG:
+    case MYSQL_TYPE_FLOAT:
+    case MYSQL_TYPE_DOUBLE:
+    case MYSQL_TYPE_NEWDECIMAL:
+    case MYSQL_TYPE_YEAR:
+    case MYSQL_TYPE_DATE:
+    case MYSQL_TYPE_DATETIME:
+    case MYSQL_TYPE_TIMESTAMP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/*
+  Get the number of records that the table scan needs to return, -1 means all.
+  When a single table is read without grouping or DISTINCT, and the whole
+  condition has been pushed down, the records after LIMIT are never used.
+  OFFSET is still skipped by MySQL, so it's included in the number.
+
+  With ORDER BY, the first records in the order are needed, so the order is
+  pushed down together if SequoiaDB sorts the fields in the same way. MySQL
+  still sorts the returned records, but only LIMIT of them.
+*/
+longlong ha_sdb::get_scan_limit(THD *thd, bson::BSONObj &order_by) {
+  longlong limit = -1;
+  LEX *lex = thd->lex;
+  SELECT_LEX *select_lex = lex->select_lex;
+  bson::BSONObjBuilder builder;
+
+  order_by = SDB_EMPTY_BSON;
+
+  if (SQLCOM_SELECT != lex->sql_command || NULL == select_lex ||
+      lex->all_selects_list != select_lex ||
+      NULL != select_lex->next_select_in_list()) {
+    goto done;
+  }
+
+  if (1 != select_lex->leaf_table_count ||
+      select_lex->group_list.elements > 0 || select_lex->with_sum_func ||
+      NULL != select_lex->having_cond() ||
+      (select_lex->active_options() & (SELECT_DISTINCT | OPTION_FOUND_ROWS))) {
+    goto done;
+  }
+
+  // pushed_cond is set only if the condition is pushed down totally
+  if (NULL != select_lex->where_cond() && NULL == pushed_cond) {
+    goto done;
+  }
+
+  if (HA_POS_ERROR == lex->unit->select_limit_cnt ||
+      0 == lex->unit->select_limit_cnt) {
+    goto done;
+  }
+
+  for (ORDER *order = select_lex->order_list.first; order != NULL;
+       order = order->next) {
+    Item *item = (*order->item)->real_item();
+    Field *field = NULL;
+    if (Item::FIELD_ITEM != item->type()) {
+      goto done;
+    }
+    field = ((Item_field *)item)->field;
+    if (field->table != table || !sdb_is_sortable_field(field)) {
+      goto done;
+    }
+    builder.append(field->field_name, ORDER_DESC == order->direction ? -1 : 1);
+  }
+
+  order_by = builder.obj();
+  limit = (longlong)lex->unit->select_limit_cnt;
+
+done:
+  return limit;
+}
+
+void ha_sdb::trace_pushdown(THD *thd, bool pushed) {
+  Thd_sdb *thd_sdb = (NULL != thd) ? thd_get_thd_sdb(thd) : NULL;
+  if (NULL != thd_sdb) {
+    Sdb_query_trace *trace =
+        thd_sdb->get_query_trace(this, db_name, table_name);
+    trace->pushdown = pushed ? "FULL" : "NONE";
+  }
+}
+
+void ha_sdb::trace_query(const char *operation,
+                         const bson::BSONObj &condition,
+                         const bson::BSONObj &selector,
+                         const bson::BSONObj &order_by,
+                         const bson::BSONObj &hint, longlong skip,
+                         longlong limit, int flag) {
+  Thd_sdb *thd_sdb = thd_get_thd_sdb(ha_thd());
+  if (NULL == thd_sdb) {
+    return;
+  }
+
+  Sdb_query_trace *trace = thd_sdb->get_query_trace(this, db_name, table_name);
+  trace->operation = operation;
+  trace->calls++;
+  trace->condition = condition;
+  trace->selector = selector;
+  trace->order_by = order_by;
+  trace->hint = hint;
+  trace->skip = skip;
+  trace->limit = limit;
+  trace->flag = flag;
+}
+
 const Item *ha_sdb::cond_push(const Item *cond) {
   const Item *remain_cond = cond;
   Sdb_cond_ctx sdb_condition;
+  THD *thd = ha_thd();
+  my_thread_id tid = (NULL != thd) ? thd->thread_id() : 0;
 
   // we can handle the condition which only involved current table,
   // can't handle conditions which involved other tables
@@ -2231,7 +2549,11 @@ const Item *ha_sdb::cond_push(const Item *cond) {
   if (SDB_COND_SUPPORTED == sdb_condition.status) {
     // TODO: build unanalysable condition
     remain_cond = NULL;
+    sdb_stat_inc(tid, SDB_STAT_COND_PUSHED);
   } else {
+    sdb_stat_inc(tid, SDB_COND_PART_SUPPORTED == sdb_condition.status
+                          ? SDB_STAT_COND_PART_UNSUPPORTED
+                          : SDB_STAT_COND_NOT_PUSHED);
     if (NULL != ha_thd()) {
       SDB_LOG_DEBUG(
           "Condition can't be pushed down. db=[%s], table[%s], sql=[%s]",
@@ -2243,6 +2565,9 @@ const Item *ha_sdb::cond_push(const Item *cond) {
     }
     pushed_condition = SDB_EMPTY_BSON;
   }
+
+  trace_pushdown(thd, NULL == remain_cond);
+
 done:
   return remain_cond;
 }
@@ -2275,6 +2600,8 @@ static void init_sdb_psi_keys(void) {
 
   count = array_elements(all_sdb_memory);
   mysql_memory_register(category, all_sdb_memory, count);
+
+  sdb_register_stages(category);
 }
 #endif
 
@@ -2284,7 +2611,7 @@ static int sdb_commit(handlerton *hton, THD *thd, bool all) {
   Thd_sdb *thd_sdb = thd_get_thd_sdb(thd);
   Sdb_conn *connection;
 
-  thd_sdb->start_stmt_count = 0;
+  my_atomic_store32(&thd_sdb->start_stmt_count, 0);
 
   connection = check_sdb_in_thd(thd, true);
   if (NULL == connection) {
@@ -2308,10 +2635,10 @@ static int sdb_commit(handlerton *hton, THD *thd, bool all) {
       the MySQL Server could handle the query without contacting the
       SequoiaDB.
     */
-    thd_sdb->save_point_count++;
+    my_atomic_add32(&thd_sdb->save_point_count, 1);
     goto done;
   }
-  thd_sdb->save_point_count = 0;
+  my_atomic_store32(&thd_sdb->save_point_count, 0);
 
   rc = connection->commit_transaction();
   if (0 != rc) {
@@ -2330,7 +2657,7 @@ static int sdb_rollback(handlerton *hton, THD *thd, bool all) {
   Thd_sdb *thd_sdb = thd_get_thd_sdb(thd);
   Sdb_conn *connection;
 
-  thd_sdb->start_stmt_count = 0;
+  my_atomic_store32(&thd_sdb->start_stmt_count, 0);
 
   connection = check_sdb_in_thd(thd, true);
   if (NULL == connection) {
@@ -2355,7 +2682,7 @@ static int sdb_rollback(handlerton *hton, THD *thd, bool all) {
     my_error(ER_WARN_ENGINE_TRANSACTION_ROLLBACK, MYF(0), "SequoiaDB");
     goto done;
   }
-  thd_sdb->save_point_count = 0;
+  my_atomic_store32(&thd_sdb->save_point_count, 0);
 
   rc = connection->rollback_transaction();
   if (0 != rc) {
@@ -2459,11 +2786,86 @@ mysql_declare_plugin(sequoiadb){
     "SequoiaDB Inc.",
     sdb_plugin_info,
     PLUGIN_LICENSE_GPL,
-    sdb_init_func, /* Plugin Init */
-    sdb_done_func, /* Plugin Deinit */
-    0x0302,        /* version */
-    NULL,          /* status variables */
-    sdb_sys_vars,  /* system variables */
-    NULL,          /* config options */
-    0,             /* flags */
-} mysql_declare_plugin_end;
+    sdb_init_func,   /* Plugin Init */
+    sdb_done_func,   /* Plugin Deinit */
+    0x0302,          /* version */
+    sdb_status_vars, /* status variables */
+    sdb_sys_vars,    /* system variables */
+    NULL,            /* config options */
+    0,               /* flags */
+},
+    {
+        MYSQL_INFORMATION_SCHEMA_PLUGIN,
+        &sdb_i_s_info,
+        "SEQUOIADB_RPC_LATENCY",
+        "SequoiaDB Inc.",
+        "Latency of the operations sent to SequoiaDB",
+        PLUGIN_LICENSE_GPL,
+        sdb_i_s_rpc_latency_init, /* Plugin Init */
+        NULL,                     /* Plugin Deinit */
+        0x0302,                   /* version */
+        NULL,                     /* status variables */
+        NULL,                     /* system variables */
+        NULL,                     /* config options */
+        0,                        /* flags */
+    },
+    {
+        MYSQL_INFORMATION_SCHEMA_PLUGIN,
+        &sdb_i_s_info,
+        "SEQUOIADB_SHARES",
+        "SequoiaDB Inc.",
+        "Shares of the SequoiaDB tables in use",
+        PLUGIN_LICENSE_GPL,
+        sdb_i_s_shares_init,      /* Plugin Init */
+        NULL,                     /* Plugin Deinit */
+        0x0302,                   /* version */
+        NULL,                     /* status variables */
+        NULL,                     /* system variables */
+        NULL,                     /* config options */
+        0,                        /* flags */
+    },
+    {
+        MYSQL_INFORMATION_SCHEMA_PLUGIN,
+        &sdb_i_s_info,
+        "SEQUOIADB_CONNECTIONS",
+        "SequoiaDB Inc.",
+        "Connections to SequoiaDB of the threads",
+        PLUGIN_LICENSE_GPL,
+        sdb_i_s_connections_init, /* Plugin Init */
+        NULL,                     /* Plugin Deinit */
+        0x0302,                   /* version */
+        NULL,                     /* status variables */
+        NULL,                     /* system variables */
+        NULL,                     /* config options */
+        0,                        /* flags */
+    },
+    {
+        MYSQL_INFORMATION_SCHEMA_PLUGIN,
+        &sdb_i_s_info,
+        "SEQUOIADB_CURSORS",
+        "SequoiaDB Inc.",
+        "Cursors open on SequoiaDB",
+        PLUGIN_LICENSE_GPL,
+        sdb_i_s_cursors_init,     /* Plugin Init */
+        NULL,                     /* Plugin Deinit */
+        0x0302,                   /* version */
+        NULL,                     /* status variables */
+        NULL,                     /* system variables */
+        NULL,                     /* config options */
+        0,                        /* flags */
+    },
+    {
+        MYSQL_INFORMATION_SCHEMA_PLUGIN,
+        &sdb_i_s_info,
+        "SEQUOIADB_PUSHED_QUERIES",
+        "SequoiaDB Inc.",
+        "Queries sent to SequoiaDB by the last statement of the session",
+        PLUGIN_LICENSE_GPL,
+        sdb_i_s_pushed_queries_init, /* Plugin Init */
+        NULL,                        /* Plugin Deinit */
+        0x0302,                      /* version */
+        NULL,                        /* status variables */
+        NULL,                        /* system variables */
+        NULL,                        /* config options */
+        0,                           /* flags */
+    } mysql_declare_plugin_end;
@@ -17,6 +17,7 @@
 #include <mysql_version.h>
 #include <client.hpp>
 #include <vector>
+#include <string>
 #include "sdb_def.h"
 #include "sdb_cl.h"
 #include "sdb_util.h"
@@ -50,6 +51,16 @@ struct Sdb_share {
   Sdb_statistics stat;
 };
 
+// A share shown in INFORMATION_SCHEMA.SEQUOIADB_SHARES.
+struct Sdb_share_info {
+  std::string table_name;
+  uint use_count;
+  Sdb_statistics stat;
+};
+
+// Copy the infos of the shares in use.
+void sdb_get_share_infos(std::vector<Sdb_share_info> &infos);
+
 class ha_sdb : public handler {
  public:
   ha_sdb(handlerton *hton, TABLE_SHARE *table_arg);
@@ -248,6 +259,7 @@ class ha_sdb : public handler {
   int rnd_pos(uchar *buf, uchar *pos);
   void position(const uchar *record);
   int info(uint);
+  int records(ha_rows *num_rows);
   int extra(enum ha_extra_function operation);
   int external_lock(THD *thd, int lock_type);
   int start_statement(THD *thd, uint table_count);
@@ -289,6 +301,9 @@ class ha_sdb : public handler {
   int row_to_obj(uchar *buf, bson::BSONObj &obj, bool gen_oid, bool output_null,
                  bson::BSONObj &null_obj);
 
+  int row_to_builder(uchar *buf, bson::BSONObjBuilder &obj_builder,
+                     bool gen_oid, bson::BSONObjBuilder *null_obj_builder);
+
   int field_to_obj(Field *field, bson::BSONObjBuilder &obj_builder);
 
   int get_update_obj(const uchar *old_data, uchar *new_data, bson::BSONObj &obj,
@@ -319,6 +334,15 @@ class ha_sdb : public handler {
 
   int get_query_flag(const uint sql_command, enum thr_lock_type lock_type);
 
+  longlong get_scan_limit(THD *thd, bson::BSONObj &order_by);
+
+  void trace_pushdown(THD *thd, bool pushed);
+
+  void trace_query(const char *operation, const bson::BSONObj &condition,
+                   const bson::BSONObj &selector, const bson::BSONObj &order_by,
+                   const bson::BSONObj &hint, longlong skip, longlong limit,
+                   int flag);
+
   int update_stats(THD *thd, bool do_read_stat);
 
  private:
@@ -338,6 +362,10 @@ class ha_sdb : public handler {
   bool m_ignore_dup_key;
   bool m_write_can_replace;
   bool m_use_bulk_insert;
+  bool m_keyread;
   std::vector<bson::BSONObj> m_bulk_insert_rows;
+  // records of the bulk insert batch are built in one buffer one by one
+  bson::BufBuilder m_bulk_insert_buf;
+  std::vector<int> m_bulk_insert_offsets;
   Sdb_obj_cache<bson::BSONElement> m_bson_element_cache;
 };
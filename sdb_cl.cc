@@ -14,13 +14,51 @@
   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
 
 #include <my_base.h>
+#include <my_sys.h>
+#include <my_atomic.h>
 #include "sdb_cl.h"
 #include "sdb_conn.h"
+#include "sdb_conf.h"
 #include "sdb_errcode.h"
+#include "sdb_stat.h"
+#include "sdb_lock.h"
+#include "sdb_thd.h"
 
 using namespace sdbclient;
 
-Sdb_cl::Sdb_cl() : m_conn(NULL), m_thread_id(0) {}
+#define SDB_CURSOR_SHARD_NUM 16
+
+struct Sdb_cursor_shard {
+  Sdb_mutex mutex;
+  Sdb_cl *head;
+  Sdb_cursor_shard() : head(NULL) {}
+};
+
+static Sdb_cursor_shard sdb_cursor_shards[SDB_CURSOR_SHARD_NUM];
+
+void sdb_get_cursor_infos(std::vector<Sdb_cursor_info> &infos) {
+  for (uint i = 0; i < SDB_CURSOR_SHARD_NUM; ++i) {
+    Sdb_cursor_shard &shard = sdb_cursor_shards[i];
+    Sdb_mutex_guard guard(shard.mutex);
+    for (Sdb_cl *cl = shard.head; cl != NULL; cl = cl->m_cursor_next) {
+      infos.push_back(cl->m_cursor_info);
+      infos.back().rows = my_atomic_load64(&cl->m_cursor_rows);
+    }
+  }
+}
+
+Sdb_cl::Sdb_cl()
+    : m_conn(NULL),
+      m_thread_id(0),
+      m_cursor_info(),
+      m_cursor_rows(0),
+      m_cursor_prev(NULL),
+      m_cursor_next(NULL),
+      m_cursor_registered(false),
+      m_cursor_fetched(false),
+      m_fetch_calls(0),
+      m_fetch_rows(0),
+      m_fetch_bytes(0) {}
 
 Sdb_cl::~Sdb_cl() {
   close();
@@ -63,6 +101,64 @@ error:
   goto done;
 }
 
+void Sdb_cl::register_cursor(const char *operation) {
+  unregister_cursor();
+
+  Sdb_cursor_shard &shard =
+      sdb_cursor_shards[m_thread_id % SDB_CURSOR_SHARD_NUM];
+  Sdb_mutex_guard guard(shard.mutex);
+  m_cursor_info.thread_id = m_thread_id;
+  m_cursor_info.operation = operation;
+  m_cursor_info.open_time = my_micro_time();
+  m_cursor_info.rows = 0;
+  my_atomic_store64(&m_cursor_rows, 0);
+  m_cursor_fetched = false;
+  snprintf(m_cursor_info.cl_full_name, sizeof(m_cursor_info.cl_full_name),
+           "%s.%s", get_cs_name(), get_cl_name());
+  m_cursor_prev = NULL;
+  m_cursor_next = shard.head;
+  if (NULL != shard.head) {
+    shard.head->m_cursor_prev = this;
+  }
+  shard.head = this;
+  m_cursor_registered = true;
+}
+
+void Sdb_cl::unregister_cursor() {
+  flush_fetch_stat();
+  if (!m_cursor_registered) {
+    return;
+  }
+
+  Sdb_cursor_shard &shard =
+      sdb_cursor_shards[m_thread_id % SDB_CURSOR_SHARD_NUM];
+  Sdb_mutex_guard guard(shard.mutex);
+  if (NULL != m_cursor_prev) {
+    m_cursor_prev->m_cursor_next = m_cursor_next;
+  } else {
+    shard.head = m_cursor_next;
+  }
+  if (NULL != m_cursor_next) {
+    m_cursor_next->m_cursor_prev = m_cursor_prev;
+  }
+  m_cursor_prev = NULL;
+  m_cursor_next = NULL;
+  m_cursor_registered = false;
+}
+
+void Sdb_cl::flush_fetch_stat() {
+  if (0 == m_fetch_calls) {
+    return;
+  }
+  sdb_stat_add(m_thread_id, SDB_STAT_CURSOR_NEXTS, m_fetch_calls);
+  sdb_stat_add(m_thread_id, SDB_STAT_ROWS_RECEIVED, m_fetch_rows);
+  sdb_stat_add(m_thread_id, SDB_STAT_BYTES_RECEIVED, m_fetch_bytes);
+  sdb_stmt_add_rows(m_fetch_rows);
+  m_fetch_calls = 0;
+  m_fetch_rows = 0;
+  m_fetch_bytes = 0;
+}
+
 bool Sdb_cl::is_transaction_on() {
   return m_conn->is_transaction_on();
 }
@@ -81,11 +177,17 @@ int Sdb_cl::query(const bson::BSONObj &condition, const bson::BSONObj &selected,
   int rc = SDB_ERR_OK;
   int retry_times = 2;
 retry:
-  rc = m_cl.query(m_cursor, condition, selected, orderBy, hint, numToSkip,
-                  numToReturn, flags);
+  {
+    Sdb_rpc_timer timer(SDB_RPC_QUERY, this, &condition);
+    SDB_DEBUG_RPC_DELAY();
+    rc = m_cl.query(m_cursor, condition, selected, orderBy, hint, numToSkip,
+                    numToReturn, flags);
+  }
   if (SDB_ERR_OK != rc) {
     goto error;
   }
+  sdb_stat_inc(m_thread_id, SDB_STAT_QUERIES);
+  register_cursor("query");
 
 done:
   return rc;
@@ -108,16 +210,22 @@ int Sdb_cl::query_one(bson::BSONObj &obj, const bson::BSONObj &condition,
   sdbclient::sdbCursor cursor_tmp;
   int retry_times = 2;
 retry:
-  rc = m_cl.query(cursor_tmp, condition, selected, orderBy, hint, numToSkip, 1,
-                  flags);
-  if (rc != SDB_ERR_OK) {
-    goto error;
+  {
+    Sdb_rpc_timer timer(SDB_RPC_QUERY_ONE, this, &condition);
+    SDB_DEBUG_RPC_DELAY();
+    rc = m_cl.query(cursor_tmp, condition, selected, orderBy, hint, numToSkip,
+                    1, flags);
+    if (rc == SDB_ERR_OK) {
+      sdb_stat_inc(m_thread_id, SDB_STAT_QUERIES);
+      rc = cursor_tmp.next(obj);
+    }
   }
-
-  rc = cursor_tmp.next(obj);
   if (rc != SDB_ERR_OK) {
     goto error;
   }
+  sdb_stat_inc(m_thread_id, SDB_STAT_ROWS_RECEIVED);
+  sdb_stmt_add_rows(1);
+  sdb_stat_add(m_thread_id, SDB_STAT_BYTES_RECEIVED, obj.objsize());
 
 done:
   return rc;
@@ -151,13 +259,26 @@ error:
 
 int Sdb_cl::next(bson::BSONObj &obj) {
   int rc = SDB_ERR_OK;
-  rc = m_cursor.next(obj);
+  ++m_fetch_calls;
+  // The driver fetches the records by batches. Only the first next() after
+  // query surely waits for SequoiaDB, the others mostly read the batch.
+  if (!m_cursor_fetched) {
+    Sdb_rpc_timer timer(SDB_RPC_FETCH, this);
+    SDB_DEBUG_RPC_DELAY();
+    rc = m_cursor.next(obj);
+    m_cursor_fetched = true;
+  } else {
+    rc = m_cursor.next(obj);
+  }
   if (rc != SDB_ERR_OK) {
     if (SDB_DMS_EOC == rc) {
       rc = HA_ERR_END_OF_FILE;
     }
     goto error;
   }
+  ++m_fetch_rows;
+  m_fetch_bytes += obj.objsize();
+  my_atomic_add64(&m_cursor_rows, 1);
 
 done:
   return rc;
@@ -170,10 +291,18 @@ int Sdb_cl::insert(bson::BSONObj &obj) {
   int rc = SDB_ERR_OK;
   int retry_times = 2;
 retry:
-  rc = m_cl.insert(obj);
+  {
+    Sdb_rpc_timer timer(SDB_RPC_INSERT, this, NULL, 1);
+    SDB_DEBUG_RPC_DELAY();
+    rc = m_cl.insert(obj);
+  }
   if (rc != SDB_ERR_OK) {
     goto error;
   }
+  sdb_stat_inc(m_thread_id, SDB_STAT_INSERTS);
+  sdb_stat_inc(m_thread_id, SDB_STAT_ROWS_SENT);
+  sdb_stmt_add_rows(1);
+  sdb_stat_add(m_thread_id, SDB_STAT_BYTES_SENT, obj.objsize());
 done:
   return rc;
 error:
@@ -189,11 +318,24 @@ error:
 
 int Sdb_cl::bulk_insert(INT32 flag, std::vector<bson::BSONObj> &objs) {
   int rc = SDB_ERR_OK;
+  longlong bytes = 0;
 
-  rc = m_cl.bulkInsert(flag, objs);
+  {
+    Sdb_rpc_timer timer(SDB_RPC_BULK_INSERT, this, NULL, objs.size());
+    SDB_DEBUG_RPC_DELAY();
+    rc = m_cl.bulkInsert(flag, objs);
+  }
   if (rc != SDB_ERR_OK) {
     goto error;
   }
+  for (std::vector<bson::BSONObj>::iterator it = objs.begin();
+       it != objs.end(); ++it) {
+    bytes += it->objsize();
+  }
+  sdb_stat_inc(m_thread_id, SDB_STAT_BULK_INSERTS);
+  sdb_stat_add(m_thread_id, SDB_STAT_ROWS_SENT, objs.size());
+  sdb_stmt_add_rows(objs.size());
+  sdb_stat_add(m_thread_id, SDB_STAT_BYTES_SENT, bytes);
 
 done:
   return rc;
@@ -208,10 +350,16 @@ int Sdb_cl::upsert(const bson::BSONObj &rule, const bson::BSONObj &condition,
   int rc = SDB_ERR_OK;
   int retry_times = 2;
 retry:
-  rc = m_cl.upsert(rule, condition, hint, setOnInsert, flag);
+  {
+    Sdb_rpc_timer timer(SDB_RPC_UPSERT, this, &condition);
+    SDB_DEBUG_RPC_DELAY();
+    rc = m_cl.upsert(rule, condition, hint, setOnInsert, flag);
+  }
   if (rc != SDB_ERR_OK) {
     goto error;
   }
+  sdb_stat_inc(m_thread_id, SDB_STAT_UPDATES);
+  sdb_stat_add(m_thread_id, SDB_STAT_BYTES_SENT, rule.objsize());
 done:
   return rc;
 error:
@@ -230,10 +378,16 @@ int Sdb_cl::update(const bson::BSONObj &rule, const bson::BSONObj &condition,
   int rc = SDB_ERR_OK;
   int retry_times = 2;
 retry:
-  rc = m_cl.update(rule, condition, hint, flag);
+  {
+    Sdb_rpc_timer timer(SDB_RPC_UPDATE, this, &condition);
+    SDB_DEBUG_RPC_DELAY();
+    rc = m_cl.update(rule, condition, hint, flag);
+  }
   if (rc != SDB_ERR_OK) {
     goto error;
   }
+  sdb_stat_inc(m_thread_id, SDB_STAT_UPDATES);
+  sdb_stat_add(m_thread_id, SDB_STAT_BYTES_SENT, rule.objsize());
 done:
   return rc;
 error:
@@ -251,10 +405,15 @@ int Sdb_cl::del(const bson::BSONObj &condition, const bson::BSONObj &hint) {
   int rc = SDB_ERR_OK;
   int retry_times = 2;
 retry:
-  rc = m_cl.del(condition, hint);
+  {
+    Sdb_rpc_timer timer(SDB_RPC_DELETE, this, &condition);
+    SDB_DEBUG_RPC_DELAY();
+    rc = m_cl.del(condition, hint);
+  }
   if (rc != SDB_ERR_OK) {
     goto error;
   }
+  sdb_stat_inc(m_thread_id, SDB_STAT_DELETES);
 done:
   return rc;
 error:
@@ -273,7 +432,11 @@ int Sdb_cl::create_index(const bson::BSONObj &indexDef, const CHAR *pName,
   int rc = SDB_ERR_OK;
   int retry_times = 2;
 retry:
-  rc = m_cl.createIndex(indexDef, pName, isUnique, isEnforced);
+  {
+    Sdb_rpc_timer timer(SDB_RPC_DDL, this);
+    SDB_DEBUG_RPC_DELAY();
+    rc = m_cl.createIndex(indexDef, pName, isUnique, isEnforced);
+  }
   if (SDB_IXM_REDEF == rc) {
     rc = SDB_ERR_OK;
   }
@@ -297,7 +460,11 @@ int Sdb_cl::drop_index(const char *pName) {
   int rc = SDB_ERR_OK;
   int retry_times = 2;
 retry:
-  rc = m_cl.dropIndex(pName);
+  {
+    Sdb_rpc_timer timer(SDB_RPC_DDL, this);
+    SDB_DEBUG_RPC_DELAY();
+    rc = m_cl.dropIndex(pName);
+  }
   if (SDB_IXM_NOTEXIST == rc) {
     rc = SDB_ERR_OK;
   }
@@ -321,7 +488,11 @@ int Sdb_cl::truncate() {
   int rc = SDB_ERR_OK;
   int retry_times = 2;
 retry:
-  rc = m_cl.truncate();
+  {
+    Sdb_rpc_timer timer(SDB_RPC_DDL, this);
+    SDB_DEBUG_RPC_DELAY();
+    rc = m_cl.truncate();
+  }
   if (rc != SDB_ERR_OK) {
     goto error;
   }
@@ -339,6 +510,7 @@ error:
 }
 
 void Sdb_cl::close() {
+  unregister_cursor();
   m_cursor.close();
 }
 
@@ -350,7 +522,11 @@ int Sdb_cl::drop() {
   int rc = SDB_ERR_OK;
   int retry_times = 2;
 retry:
-  rc = m_cl.drop();
+  {
+    Sdb_rpc_timer timer(SDB_RPC_DDL, this);
+    SDB_DEBUG_RPC_DELAY();
+    rc = m_cl.drop();
+  }
   if (rc != SDB_ERR_OK) {
     if (SDB_DMS_NOTEXIST == rc) {
       rc = SDB_ERR_OK;
@@ -377,7 +553,11 @@ int Sdb_cl::get_count(long long &count,
   int rc = SDB_ERR_OK;
   int retry_times = 2;
 retry:
-  rc = m_cl.getCount(count, condition, hint);
+  {
+    Sdb_rpc_timer timer(SDB_RPC_COUNT, this, &condition);
+    SDB_DEBUG_RPC_DELAY();
+    rc = m_cl.getCount(count, condition, hint);
+  }
   if (rc != SDB_ERR_OK) {
     goto error;
   }
@@ -22,6 +22,18 @@
 #include "sdb_def.h"
 #include "sdb_conn.h"
 
+// An open cursor shown in INFORMATION_SCHEMA.SEQUOIADB_CURSORS.
+struct Sdb_cursor_info {
+  my_thread_id thread_id;
+  const char *operation;
+  ulonglong open_time;
+  ulonglong rows;
+  char cl_full_name[SDB_CS_NAME_MAX_SIZE + SDB_CL_NAME_MAX_SIZE + 2];
+};
+
+// Copy the infos of the cursors which are open now.
+void sdb_get_cursor_infos(std::vector<Sdb_cursor_info> &infos);
+
 class Sdb_cl {
  public:
   Sdb_cl();
@@ -86,10 +98,33 @@ class Sdb_cl {
                 const bson::BSONObj &condition = SDB_EMPTY_BSON, 
                 const bson::BSONObj &hint = SDB_EMPTY_BSON);
 
+ private:
+  void register_cursor(const char *operation);
+
+  void unregister_cursor();
+
+  void flush_fetch_stat();
+
  private:
   Sdb_conn *m_conn;
   my_thread_id m_thread_id;
   sdbclient::sdbCollection m_cl;
   sdbclient::sdbCursor m_cursor;
+
+  // registered while m_cursor is open
+  Sdb_cursor_info m_cursor_info;
+  // rows of m_cursor, read by other threads without the shard mutex
+  volatile int64 m_cursor_rows;
+  Sdb_cl *m_cursor_prev;
+  Sdb_cl *m_cursor_next;
+  bool m_cursor_registered;
+
+  // fetching of m_cursor, added to the status counters when it's closed
+  bool m_cursor_fetched;
+  ulonglong m_fetch_calls;
+  ulonglong m_fetch_rows;
+  ulonglong m_fetch_bytes;
+
+  friend void sdb_get_cursor_infos(std::vector<Sdb_cursor_info> &infos);
 };
 #endif
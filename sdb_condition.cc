@@ -273,8 +273,28 @@ Sdb_item *Sdb_cond_ctx::create_sdb_item(Item_func *cond_item) {
       item = new Sdb_func_like((Item_func_like *)cond_item);
       break;
     }
+    case Item_func::NOT_FUNC: {
+      item = new Sdb_not_item(TRUE, FALSE);
+      break;
+    }
+    case Item_func::XOR_FUNC: {
+      item = new Sdb_xor_item();
+      break;
+    }
     default: {
-      item = new Sdb_func_unkown(cond_item);
+      // the truth tests have no functype of their own
+      const char *func_name = cond_item->func_name();
+      if (0 == strcmp(func_name, "istrue")) {
+        item = new Sdb_not_item(FALSE, FALSE);
+      } else if (0 == strcmp(func_name, "isnottrue")) {
+        item = new Sdb_not_item(FALSE, TRUE);
+      } else if (0 == strcmp(func_name, "isfalse")) {
+        item = new Sdb_not_item(TRUE, FALSE);
+      } else if (0 == strcmp(func_name, "isnotfalse")) {
+        item = new Sdb_not_item(TRUE, TRUE);
+      } else {
+        item = new Sdb_func_unkown(cond_item);
+      }
       break;
     }
   }
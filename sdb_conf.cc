@@ -15,6 +15,7 @@
 
 #include "sdb_conf.h"
 #include "sdb_lock.h"
+#include "sdb_stat.h"
 
 static const char *SDB_ADDR_DFT = "localhost:11810";
 static const char *SDB_USER_DFT = "";
@@ -25,6 +26,10 @@ static const my_bool SDB_DEFAULT_USE_BULK_INSERT = TRUE;
 static const my_bool SDB_DEFAULT_USE_AUTOCOMMIT = TRUE;
 static const int SDB_DEFAULT_BULK_INSERT_SIZE = 100;
 static const int SDB_DEFAULT_REPLICA_SIZE = -1;
+static const my_bool SDB_DEFAULT_PREFETCH = FALSE;
+static const my_bool SDB_DEFAULT_PARALLEL_SCAN = FALSE;
+static const int SDB_DEFAULT_SLOW_OP_THRESHOLD = 0;
+static const uint SDB_DEFAULT_STMT_RPC_WARN_THRESHOLD = 0;
 
 char *sdb_conn_str = NULL;
 char *sdb_user = NULL;
@@ -35,11 +40,17 @@ int sdb_bulk_insert_size = SDB_DEFAULT_BULK_INSERT_SIZE;
 int sdb_replica_size = SDB_DEFAULT_REPLICA_SIZE;
 my_bool sdb_use_autocommit = SDB_DEFAULT_USE_AUTOCOMMIT;
 my_bool sdb_debug_log = SDB_DEBUG_LOG_DFT;
+int sdb_slow_op_threshold = SDB_DEFAULT_SLOW_OP_THRESHOLD;
+#ifndef DBUG_OFF
+uint sdb_debug_rpc_delay = 0;
+#endif
 
 static String sdb_encoded_password;
 static Sdb_encryption sdb_passwd_encryption;
 static Sdb_rwlock sdb_password_lock;
 
+static my_bool sdb_rpc_latency_reset_dummy = FALSE;
+
 static int sdb_conn_addr_validate(THD *thd, struct st_mysql_sys_var *var,
                                   void *save, struct st_mysql_value *value) {
   // The buffer size is not important. Because st_mysql_value::val_str
@@ -63,6 +74,15 @@ static void sdb_password_update(THD *thd, struct st_mysql_sys_var *var,
   sdb_encrypt_password();
 }
 
+// Reset the histograms, the variable itself always stays OFF.
+static void sdb_rpc_latency_reset_update(THD *thd,
+                                         struct st_mysql_sys_var *var,
+                                         void *var_ptr, const void *save) {
+  if (*static_cast<const my_bool *>(save)) {
+    sdb_rpc_latency_reset();
+  }
+}
+
 static MYSQL_SYSVAR_STR(conn_addr, sdb_conn_str,
                         PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_MEMALLOC,
                         "SequoiaDB addresses (Default: localhost:11810).",
@@ -103,13 +123,72 @@ static MYSQL_SYSVAR_BOOL(debug_log, sdb_debug_log, PLUGIN_VAR_OPCMDARG,
                          "Turn on debug log of SequoiaDB storage engine. "
                          "Disabled by default.",
                          NULL, NULL, SDB_DEBUG_LOG_DFT);
+static MYSQL_THDVAR_BOOL(prefetch, PLUGIN_VAR_OPCMDARG,
+                         "Let SequoiaDB prepare the next batch of records "
+                         "while the current one is being read in scans. "
+                         "Disabled by default.",
+                         NULL, NULL, SDB_DEFAULT_PREFETCH);
+static MYSQL_THDVAR_BOOL(parallel_scan, PLUGIN_VAR_OPCMDARG,
+                         "Scan the sub-collections of SequoiaDB in parallel "
+                         "in the full table scans without order. "
+                         "Disabled by default.",
+                         NULL, NULL, SDB_DEFAULT_PARALLEL_SCAN);
+
+static MYSQL_SYSVAR_BOOL(rpc_latency_reset, sdb_rpc_latency_reset_dummy,
+                         PLUGIN_VAR_NOCMDARG,
+                         "Set to ON to reset the statistics of "
+                         "INFORMATION_SCHEMA.SEQUOIADB_RPC_LATENCY.",
+                         NULL, sdb_rpc_latency_reset_update, FALSE);
+
+static MYSQL_SYSVAR_INT(slow_op_threshold, sdb_slow_op_threshold,
+                        PLUGIN_VAR_OPCMDARG,
+                        "Log the operations on SequoiaDB slower than this "
+                        "number of milliseconds, 0 to disable "
+                        "(Default: 0).",
+                        NULL, NULL, SDB_DEFAULT_SLOW_OP_THRESHOLD, 0, 3600000,
+                        0);
+
+static MYSQL_THDVAR_UINT(stmt_rpc_warn_threshold, PLUGIN_VAR_OPCMDARG,
+                         "Raise a warning when a statement sends more "
+                         "requests than this number to SequoiaDB, 0 to "
+                         "disable (Default: 0).",
+                         NULL, NULL, SDB_DEFAULT_STMT_RPC_WARN_THRESHOLD, 0,
+                         UINT_MAX, 0);
+#ifndef DBUG_OFF
+static MYSQL_SYSVAR_UINT(debug_rpc_delay, sdb_debug_rpc_delay,
+                         PLUGIN_VAR_OPCMDARG,
+                         "Sleep this number of microseconds in each request "
+                         "to SequoiaDB when the debug keyword sdb_rpc_delay "
+                         "is set, to simulate a remote coordinator. Cursor "
+                         "reads from the fetched batch are not delayed "
+                         "(Default: 0).",
+                         NULL, NULL, 0, 0, 10000000, 0);
+#endif
 
 struct st_mysql_sys_var *sdb_sys_vars[] = {
-    MYSQL_SYSVAR(conn_addr),       MYSQL_SYSVAR(user),
-    MYSQL_SYSVAR(password),        MYSQL_SYSVAR(use_partition),
-    MYSQL_SYSVAR(use_bulk_insert), MYSQL_SYSVAR(bulk_insert_size),
-    MYSQL_SYSVAR(replica_size),    MYSQL_SYSVAR(use_autocommit),
-    MYSQL_SYSVAR(debug_log),       NULL};
+    MYSQL_SYSVAR(conn_addr),         MYSQL_SYSVAR(user),
+    MYSQL_SYSVAR(password),          MYSQL_SYSVAR(use_partition),
+    MYSQL_SYSVAR(use_bulk_insert),   MYSQL_SYSVAR(bulk_insert_size),
+    MYSQL_SYSVAR(replica_size),      MYSQL_SYSVAR(use_autocommit),
+    MYSQL_SYSVAR(debug_log),         MYSQL_SYSVAR(prefetch),
+    MYSQL_SYSVAR(parallel_scan),     MYSQL_SYSVAR(rpc_latency_reset),
+    MYSQL_SYSVAR(slow_op_threshold), MYSQL_SYSVAR(stmt_rpc_warn_threshold),
+#ifndef DBUG_OFF
+    MYSQL_SYSVAR(debug_rpc_delay),
+#endif
+    NULL};
+
+my_bool sdb_prefetch(THD *thd) {
+  return THDVAR(thd, prefetch);
+}
+
+my_bool sdb_parallel_scan(THD *thd) {
+  return THDVAR(thd, parallel_scan);
+}
+
+uint sdb_stmt_rpc_warn_threshold(THD *thd) {
+  return THDVAR(thd, stmt_rpc_warn_threshold);
+}
 
 Sdb_conn_addrs::Sdb_conn_addrs() : conn_num(0) {
   for (int i = 0; i < SDB_COORD_NUM_MAX; i++) {
@@ -57,6 +57,19 @@ extern int sdb_bulk_insert_size;
 extern int sdb_replica_size;
 extern my_bool sdb_use_autocommit;
 extern my_bool sdb_debug_log;
+extern int sdb_slow_op_threshold;
+#ifndef DBUG_OFF
+extern uint sdb_debug_rpc_delay;
+#endif
+
+// Simulate a remote coordinator in debug builds, by SET GLOBAL debug =
+// '+d,sdb_rpc_delay'. Put it at the requests to SequoiaDB, after the timer.
+#define SDB_DEBUG_RPC_DELAY() \
+  DBUG_EXECUTE_IF("sdb_rpc_delay", my_sleep(sdb_debug_rpc_delay);)
 extern st_mysql_sys_var *sdb_sys_vars[];
 
+my_bool sdb_prefetch(THD *thd);
+my_bool sdb_parallel_scan(THD *thd);
+uint sdb_stmt_rpc_warn_threshold(THD *thd);
+
 #endif
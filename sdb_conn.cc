@@ -19,6 +19,7 @@
 
 #include "sdb_conn.h"
 #include <sql_class.h>
+#include <my_atomic.h>
 #include <client.hpp>
 #include <sstream>
 #include "sdb_cl.h"
@@ -28,9 +29,10 @@
 #include "sdb_conf.h"
 #include "sdb_log.h"
 #include "ha_sdb.h"
+#include "sdb_stat.h"
 
 Sdb_conn::Sdb_conn(my_thread_id _tid)
-    : m_transaction_on(false), m_thread_id(_tid) {}
+    : m_transaction_on(0), m_connected(false), m_thread_id(_tid) {}
 
 Sdb_conn::~Sdb_conn() {}
 
@@ -47,7 +49,7 @@ int Sdb_conn::connect() {
   String password;
 
   if (!m_connection.isValid()) {
-    m_transaction_on = false;
+    my_atomic_store32(&m_transaction_on, 0);
     Sdb_conn_addrs conn_addrs;
     rc = conn_addrs.parse_conn_addrs(sdb_conn_str);
     if (SDB_ERR_OK != rc) {
@@ -66,6 +68,10 @@ int Sdb_conn::connect() {
     if (SDB_ERR_OK != rc) {
       goto error;
     }
+    if (m_connected) {
+      sdb_stat_inc(m_thread_id, SDB_STAT_RECONNECTS);
+    }
+    m_connected = true;
   }
 
 done:
@@ -79,9 +85,14 @@ int Sdb_conn::begin_transaction() {
   int rc = SDB_ERR_OK;
   int retry_times = 2;
   while (!m_transaction_on) {
-    rc = m_connection.transactionBegin();
+    {
+      Sdb_rpc_timer timer(SDB_RPC_TRANS_BEGIN);
+      SDB_DEBUG_RPC_DELAY();
+      rc = m_connection.transactionBegin();
+    }
     if (SDB_ERR_OK == rc) {
-      m_transaction_on = true;
+      my_atomic_store32(&m_transaction_on, 1);
+      sdb_stat_inc(m_thread_id, SDB_STAT_TRANS_BEGINS);
       break;
     } else if (IS_SDB_NET_ERR(rc) && --retry_times > 0) {
       connect();
@@ -100,11 +111,16 @@ error:
 int Sdb_conn::commit_transaction() {
   int rc = SDB_ERR_OK;
   if (m_transaction_on) {
-    m_transaction_on = false;
-    rc = m_connection.transactionCommit();
+    my_atomic_store32(&m_transaction_on, 0);
+    {
+      Sdb_rpc_timer timer(SDB_RPC_TRANS_COMMIT);
+      SDB_DEBUG_RPC_DELAY();
+      rc = m_connection.transactionCommit();
+    }
     if (rc != SDB_ERR_OK) {
       goto error;
     }
+    sdb_stat_inc(m_thread_id, SDB_STAT_TRANS_COMMITS);
   }
 
 done:
@@ -120,8 +136,13 @@ error:
 int Sdb_conn::rollback_transaction() {
   if (m_transaction_on) {
     int rc = SDB_ERR_OK;
-    m_transaction_on = false;
-    rc = m_connection.transactionRollback();
+    my_atomic_store32(&m_transaction_on, 0);
+    {
+      Sdb_rpc_timer timer(SDB_RPC_TRANS_ROLLBACK);
+      SDB_DEBUG_RPC_DELAY();
+      rc = m_connection.transactionRollback();
+    }
+    sdb_stat_inc(m_thread_id, SDB_STAT_TRANS_ROLLBACKS);
     if (IS_SDB_NET_ERR(rc)) {
       connect();
     }
@@ -130,7 +151,7 @@ int Sdb_conn::rollback_transaction() {
 }
 
 bool Sdb_conn::is_transaction_on() {
-  return m_transaction_on;
+  return 0 != my_atomic_load32(&m_transaction_on);
 }
 
 int Sdb_conn::get_cl(char *cs_name, char *cl_name, Sdb_cl &cl) {
@@ -173,7 +194,11 @@ retry:
     goto error;
   }
 
-  rc = cs.createCollection(cl_name, options, cl);
+  {
+    Sdb_rpc_timer timer(SDB_RPC_DDL);
+    SDB_DEBUG_RPC_DELAY();
+    rc = cs.createCollection(cl_name, options, cl);
+  }
   if (SDB_DMS_EXIST == rc) {
     rc = cs.getCollection(cl_name, cl);
   } else if (SDB_OK == rc) {
@@ -221,7 +246,11 @@ retry:
     goto error;
   }
 
-  rc = cs.renameCollection(old_cl_name, new_cl_name);
+  {
+    Sdb_rpc_timer timer(SDB_RPC_DDL);
+    SDB_DEBUG_RPC_DELAY();
+    rc = cs.renameCollection(old_cl_name, new_cl_name);
+  }
   if (rc != SDB_ERR_OK) {
     goto error;
   }
@@ -254,7 +283,11 @@ retry:
     goto error;
   }
 
-  rc = cs.dropCollection(cl_name);
+  {
+    Sdb_rpc_timer timer(SDB_RPC_DDL);
+    SDB_DEBUG_RPC_DELAY();
+    rc = cs.dropCollection(cl_name);
+  }
   if (rc != SDB_ERR_OK) {
     if (SDB_DMS_NOTEXIST == rc) {
       // There is no specified collection, igonre the error.
@@ -278,7 +311,11 @@ error:
 
 int Sdb_conn::drop_cs(char *cs_name) {
   int rc = SDB_ERR_OK;
-  rc = m_connection.dropCollectionSpace(cs_name);
+  {
+    Sdb_rpc_timer timer(SDB_RPC_DDL);
+    SDB_DEBUG_RPC_DELAY();
+    rc = m_connection.dropCollectionSpace(cs_name);
+  }
   if (rc != SDB_ERR_OK) {
     goto error;
   }
@@ -333,12 +370,14 @@ int Sdb_conn::get_cl_statistics(char *cs_name, char *cl_name,
   std::string sql = ss.str();
 
 retry:
-  rc = m_connection.exec(sql.c_str(), cursor);
-  if (rc != SDB_ERR_OK) {
-    goto error;
+  {
+    Sdb_rpc_timer timer(SDB_RPC_EXEC);
+    SDB_DEBUG_RPC_DELAY();
+    rc = m_connection.exec(sql.c_str(), cursor);
+    if (rc == SDB_ERR_OK) {
+      rc = cursor.next(obj);
+    }
   }
-
-  rc = cursor.next(obj);
   if (rc != SDB_ERR_OK) {
     goto error;
   }
@@ -62,7 +62,9 @@ class Sdb_conn {
 
  private:
   sdbclient::sdb m_connection;
-  bool m_transaction_on;
+  // read by sdb_get_conn_infos() in other threads
+  volatile int32 m_transaction_on;
+  bool m_connected;
   my_thread_id m_thread_id;
 };
 
@@ -23,9 +23,13 @@
 
 #define SDB_IDX_FIELD_SIZE_MAX 1024
 #define SDB_MATCH_FIELD_SIZE_MAX 1024
+// larger IN lists are not pushed down, but filtered by mysqld
+#define SDB_MATCH_IN_NUM_MAX 100000
 
 #define SDB_CHARSET my_charset_utf8mb4_bin
 
+#define SDB_OID_FIELD "_id"
+
 const static bson::BSONObj SDB_EMPTY_BSON;
 
 #endif
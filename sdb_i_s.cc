@@ -0,0 +1,300 @@
+/* Copyright (c) 2019, SequoiaDB and/or its affiliates. All rights reserved.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#ifndef MYSQL_SERVER
+#define MYSQL_SERVER
+#endif
+
+#include "sdb_i_s.h"
+#include <sql_class.h>
+#include <sql_show.h>
+#include <table.h>
+#include "sdb_stat.h"
+#include "sdb_thd.h"
+#include "sdb_cl.h"
+#include "ha_sdb.h"
+
+struct st_mysql_information_schema sdb_i_s_info = {
+    MYSQL_INFORMATION_SCHEMA_INTERFACE_VERSION};
+
+#define SDB_I_S_BIGINT(name, flags)                                   \
+  {                                                                   \
+    name, MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0, flags, \
+        "", SKIP_OPEN_TABLE                                           \
+  }
+
+#define SDB_I_S_STRING(name, length) \
+  { name, length, MYSQL_TYPE_STRING, 0, 0, "", SKIP_OPEN_TABLE }
+
+#define SDB_I_S_END \
+  { 0, 0, MYSQL_TYPE_NULL, 0, 0, 0, 0 }
+
+static ST_FIELD_INFO sdb_rpc_latency_fields[] = {
+    SDB_I_S_STRING("OPERATION", 32),
+    SDB_I_S_BIGINT("CALLS", MY_I_S_UNSIGNED),
+    SDB_I_S_BIGINT("TOTAL_US", MY_I_S_UNSIGNED),
+    SDB_I_S_BIGINT("P50_US", MY_I_S_UNSIGNED),
+    SDB_I_S_BIGINT("P95_US", MY_I_S_UNSIGNED),
+    SDB_I_S_BIGINT("P99_US", MY_I_S_UNSIGNED),
+    SDB_I_S_BIGINT("MAX_US", MY_I_S_UNSIGNED),
+    SDB_I_S_END};
+
+static int sdb_rpc_latency_fill(THD *thd, TABLE_LIST *tables, Item *cond) {
+  int rc = 0;
+  TABLE *table = tables->table;
+
+  for (uint op = 0; op < SDB_RPC_OP_NUM; ++op) {
+    Sdb_latency_stat stat;
+    const char *name = sdb_rpc_op_name((SDB_RPC_OP)op);
+    sdb_rpc_latency_get((SDB_RPC_OP)op, stat);
+
+    table->field[0]->store(name, strlen(name), system_charset_info);
+    table->field[1]->store(stat.calls, true);
+    table->field[2]->store(stat.total, true);
+    table->field[3]->store(stat.p50, true);
+    table->field[4]->store(stat.p95, true);
+    table->field[5]->store(stat.p99, true);
+    table->field[6]->store(stat.max, true);
+    rc = schema_table_store_record(thd, table);
+    if (rc) {
+      goto error;
+    }
+  }
+
+done:
+  return rc;
+error:
+  goto done;
+}
+
+int sdb_i_s_rpc_latency_init(void *p) {
+  ST_SCHEMA_TABLE *schema = (ST_SCHEMA_TABLE *)p;
+  schema->fields_info = sdb_rpc_latency_fields;
+  schema->fill_table = sdb_rpc_latency_fill;
+  return 0;
+}
+
+/*
+  The following tables copy the state out under the locks first, and fill
+  the rows after the locks are released.
+*/
+static ST_FIELD_INFO sdb_shares_fields[] = {
+    SDB_I_S_STRING("TABLE_NAME", FN_REFLEN),
+    SDB_I_S_BIGINT("USE_COUNT", MY_I_S_UNSIGNED),
+    SDB_I_S_BIGINT("PAGE_SIZE", 0),
+    SDB_I_S_BIGINT("DATA_PAGES", 0),
+    SDB_I_S_BIGINT("INDEX_PAGES", 0),
+    SDB_I_S_BIGINT("DATA_FREE_SPACE", 0),
+    SDB_I_S_BIGINT("TOTAL_RECORDS", 0),
+    SDB_I_S_END};
+
+static int sdb_shares_fill(THD *thd, TABLE_LIST *tables, Item *cond) {
+  int rc = 0;
+  TABLE *table = tables->table;
+  std::vector<Sdb_share_info> infos;
+
+  // TOTAL_RECORDS is -1 until the statistics are fetched.
+  sdb_get_share_infos(infos);
+  for (std::vector<Sdb_share_info>::iterator it = infos.begin();
+       it != infos.end(); ++it) {
+    table->field[0]->store(it->table_name.c_str(), it->table_name.length(),
+                           system_charset_info);
+    table->field[1]->store(it->use_count, true);
+    table->field[2]->store(it->stat.page_size, false);
+    table->field[3]->store(it->stat.total_data_pages, false);
+    table->field[4]->store(it->stat.total_index_pages, false);
+    table->field[5]->store(it->stat.total_data_free_space, false);
+    table->field[6]->store(it->stat.total_records, false);
+    rc = schema_table_store_record(thd, table);
+    if (rc) {
+      goto error;
+    }
+  }
+
+done:
+  return rc;
+error:
+  goto done;
+}
+
+int sdb_i_s_shares_init(void *p) {
+  ST_SCHEMA_TABLE *schema = (ST_SCHEMA_TABLE *)p;
+  schema->fields_info = sdb_shares_fields;
+  schema->fill_table = sdb_shares_fill;
+  return 0;
+}
+
+static ST_FIELD_INFO sdb_connections_fields[] = {
+    SDB_I_S_BIGINT("THREAD_ID", MY_I_S_UNSIGNED),
+    SDB_I_S_STRING("IS_SLAVE", 3),
+    SDB_I_S_STRING("IN_TRANSACTION", 3),
+    SDB_I_S_BIGINT("LOCK_COUNT", MY_I_S_UNSIGNED),
+    SDB_I_S_BIGINT("START_STMT_COUNT", MY_I_S_UNSIGNED),
+    SDB_I_S_BIGINT("SAVE_POINT_COUNT", MY_I_S_UNSIGNED),
+    SDB_I_S_END};
+
+static void sdb_store_yes_no(Field *field, bool value) {
+  if (value) {
+    field->store(STRING_WITH_LEN("YES"), system_charset_info);
+  } else {
+    field->store(STRING_WITH_LEN("NO"), system_charset_info);
+  }
+}
+
+static int sdb_connections_fill(THD *thd, TABLE_LIST *tables, Item *cond) {
+  int rc = 0;
+  TABLE *table = tables->table;
+  std::vector<Sdb_conn_info> infos;
+
+  sdb_get_conn_infos(infos);
+  for (std::vector<Sdb_conn_info>::iterator it = infos.begin();
+       it != infos.end(); ++it) {
+    table->field[0]->store(it->thread_id, true);
+    sdb_store_yes_no(table->field[1], it->slave_thread);
+    sdb_store_yes_no(table->field[2], it->transaction_on);
+    table->field[3]->store(it->lock_count, true);
+    table->field[4]->store(it->start_stmt_count, true);
+    table->field[5]->store(it->save_point_count, true);
+    rc = schema_table_store_record(thd, table);
+    if (rc) {
+      goto error;
+    }
+  }
+
+done:
+  return rc;
+error:
+  goto done;
+}
+
+int sdb_i_s_connections_init(void *p) {
+  ST_SCHEMA_TABLE *schema = (ST_SCHEMA_TABLE *)p;
+  schema->fields_info = sdb_connections_fields;
+  schema->fill_table = sdb_connections_fill;
+  return 0;
+}
+
+static ST_FIELD_INFO sdb_cursors_fields[] = {
+    SDB_I_S_BIGINT("THREAD_ID", MY_I_S_UNSIGNED),
+    SDB_I_S_STRING("COLLECTION",
+                   SDB_CS_NAME_MAX_SIZE + SDB_CL_NAME_MAX_SIZE + 1),
+    SDB_I_S_STRING("OPERATION", 32),
+    SDB_I_S_BIGINT("ROWS_FETCHED", MY_I_S_UNSIGNED),
+    SDB_I_S_BIGINT("ELAPSED_US", MY_I_S_UNSIGNED),
+    SDB_I_S_END};
+
+static int sdb_cursors_fill(THD *thd, TABLE_LIST *tables, Item *cond) {
+  int rc = 0;
+  TABLE *table = tables->table;
+  std::vector<Sdb_cursor_info> infos;
+  ulonglong now = my_micro_time();
+
+  sdb_get_cursor_infos(infos);
+  for (std::vector<Sdb_cursor_info>::iterator it = infos.begin();
+       it != infos.end(); ++it) {
+    table->field[0]->store(it->thread_id, true);
+    table->field[1]->store(it->cl_full_name, strlen(it->cl_full_name),
+                           system_charset_info);
+    table->field[2]->store(it->operation, strlen(it->operation),
+                           system_charset_info);
+    table->field[3]->store(it->rows, true);
+    table->field[4]->store(now > it->open_time ? now - it->open_time : 0,
+                           true);
+    rc = schema_table_store_record(thd, table);
+    if (rc) {
+      goto error;
+    }
+  }
+
+done:
+  return rc;
+error:
+  goto done;
+}
+
+int sdb_i_s_cursors_init(void *p) {
+  ST_SCHEMA_TABLE *schema = (ST_SCHEMA_TABLE *)p;
+  schema->fields_info = sdb_cursors_fields;
+  schema->fill_table = sdb_cursors_fill;
+  return 0;
+}
+
+#define SDB_I_S_BSON_LENGTH 65535
+
+static ST_FIELD_INFO sdb_pushed_queries_fields[] = {
+    SDB_I_S_STRING("TABLE_NAME", FN_REFLEN),
+    SDB_I_S_STRING("PUSHDOWN", 8),
+    SDB_I_S_STRING("OPERATION", 32),
+    SDB_I_S_BIGINT("CALLS", MY_I_S_UNSIGNED),
+    SDB_I_S_STRING("CONDITION", SDB_I_S_BSON_LENGTH),
+    SDB_I_S_STRING("SELECTOR", SDB_I_S_BSON_LENGTH),
+    SDB_I_S_STRING("ORDER_BY", SDB_I_S_BSON_LENGTH),
+    SDB_I_S_STRING("HINT", SDB_I_S_BSON_LENGTH),
+    SDB_I_S_BIGINT("SKIP", 0),
+    SDB_I_S_BIGINT("LIMIT", 0),
+    SDB_I_S_BIGINT("FLAG", 0),
+    SDB_I_S_END};
+
+static void sdb_store_bson(Field *field, const bson::BSONObj &obj) {
+  std::string str = obj.toString();
+  field->store(str.c_str(), MY_MIN(str.length(), SDB_I_S_BSON_LENGTH),
+               system_charset_info);
+}
+
+// Only the queries of the current session are shown.
+static int sdb_pushed_queries_fill(THD *thd, TABLE_LIST *tables,
+                                   Item *cond) {
+  int rc = 0;
+  TABLE *table = tables->table;
+  Thd_sdb *thd_sdb = thd_get_thd_sdb(thd);
+  if (NULL == thd_sdb) {
+    goto done;
+  }
+
+  for (std::vector<Sdb_query_trace>::iterator it =
+           thd_sdb->get_query_traces().begin();
+       it != thd_sdb->get_query_traces().end(); ++it) {
+    table->field[0]->store(it->table_name.c_str(), it->table_name.length(),
+                           system_charset_info);
+    table->field[1]->store(it->pushdown, strlen(it->pushdown),
+                           system_charset_info);
+    table->field[2]->store(it->operation, strlen(it->operation),
+                           system_charset_info);
+    table->field[3]->store(it->calls, true);
+    sdb_store_bson(table->field[4], it->condition);
+    sdb_store_bson(table->field[5], it->selector);
+    sdb_store_bson(table->field[6], it->order_by);
+    sdb_store_bson(table->field[7], it->hint);
+    table->field[8]->store(it->skip, false);
+    table->field[9]->store(it->limit, false);
+    table->field[10]->store(it->flag, false);
+    rc = schema_table_store_record(thd, table);
+    if (rc) {
+      goto error;
+    }
+  }
+
+done:
+  return rc;
+error:
+  goto done;
+}
+
+int sdb_i_s_pushed_queries_init(void *p) {
+  ST_SCHEMA_TABLE *schema = (ST_SCHEMA_TABLE *)p;
+  schema->fields_info = sdb_pushed_queries_fields;
+  schema->fill_table = sdb_pushed_queries_fill;
+  return 0;
+}
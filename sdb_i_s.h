@@ -0,0 +1,34 @@
+/* Copyright (c) 2019, SequoiaDB and/or its affiliates. All rights reserved.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#ifndef SDB_I_S__H
+#define SDB_I_S__H
+
+#include <my_global.h>
+#include <mysql/plugin.h>
+
+extern struct st_mysql_information_schema sdb_i_s_info;
+
+int sdb_i_s_rpc_latency_init(void *p);
+
+int sdb_i_s_shares_init(void *p);
+
+int sdb_i_s_connections_init(void *p);
+
+int sdb_i_s_cursors_init(void *p);
+
+int sdb_i_s_pushed_queries_init(void *p);
+
+#endif /* SDB_I_S__H */
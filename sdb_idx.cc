@@ -141,6 +141,33 @@ error:
   goto done;
 }
 
+/*
+  Select the key fields and _id only, for the index-only reads. $include
+  doesn't return the missing fields, so that they are still read as NULL.
+*/
+int sdb_get_idx_selector(KEY *key_info, bson::BSONObj &selector) {
+  int rc = SDB_ERR_OK;
+  const KEY_PART_INFO *key_part;
+  const KEY_PART_INFO *key_end;
+  bson::BSONObjBuilder obj_builder;
+  if (!key_info) {
+    rc = SDB_ERR_INVALID_ARG;
+    goto error;
+  }
+  obj_builder.append(SDB_OID_FIELD, BSON("$include" << 1));
+  key_part = key_info->key_part;
+  key_end = key_part + key_info->user_defined_key_parts;
+  for (; key_part != key_end; ++key_part) {
+    obj_builder.append(key_part->field->field_name, BSON("$include" << 1));
+  }
+  selector = obj_builder.obj();
+
+done:
+  return rc;
+error:
+  goto done;
+}
+
 static void get_int_key_obj(const uchar *key_ptr, const KEY_PART_INFO *key_part,
                             const char *op_str, bson::BSONObj &obj) {
   bson::BSONObjBuilder obj_builder;
@@ -24,6 +24,8 @@ int sdb_create_index(const KEY *key_info, Sdb_cl &cl);
 
 int sdb_get_idx_order(KEY *key_info, bson::BSONObj &order, int order_direction);
 
+int sdb_get_idx_selector(KEY *key_info, bson::BSONObj &selector);
+
 int sdb_create_condition_from_key(TABLE *table, KEY *key_info,
                                   const key_range *start_key,
                                   const key_range *end_key,
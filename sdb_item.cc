@@ -25,6 +25,8 @@
 #include "sdb_def.h"
 #include <json_dom.h>
 #include <item_json_func.h>
+#include <algorithm>
+#include <vector>
 
 #define BSON_APPEND(field_name, value, obj, arr_builder) \
   do {                                                   \
@@ -38,6 +40,150 @@
 static const uint MAX_TIME_DEC = 6;
 static const uint POWER_10[7] = {1, 10, 100, 1000, 10000, 100000, 1000000};
 
+enum SDB_FUNC_KIND {
+  SDB_FUNC_STRING = 1,  // string -> string, compared with the column type
+  SDB_FUNC_LENGTH,      // string -> integer
+  SDB_FUNC_SUBSTR,      // string -> string, with constant start and length
+  SDB_FUNC_DATE,        // temporal -> date, rewritten into a range
+  SDB_FUNC_YEAR         // temporal -> year, rewritten into a range
+};
+
+struct Sdb_func_map {
+  const char *func_name;  // Item_func::func_name()
+  const char *sdb_op;     // functional operator of SequoiaDB matcher
+  uint arg_count;
+  SDB_FUNC_KIND kind;
+};
+
+/*
+  MySQL functions which can be pushed down when they are applied to a column
+  of current table and compared with a constant, such as `UPPER(a) = 'X'`.
+  DATE() and YEAR() are monotonic, so they are rewritten into ranges of the
+  column itself, which can use the index.
+*/
+static const Sdb_func_map SDB_FUNC_MAPS[] = {
+    {"lower", "$lower", 1, SDB_FUNC_STRING},
+    {"upper", "$upper", 1, SDB_FUNC_STRING},
+    {"trim", "$trim", 1, SDB_FUNC_STRING},
+    {"ltrim", "$ltrim", 1, SDB_FUNC_STRING},
+    {"rtrim", "$rtrim", 1, SDB_FUNC_STRING},
+    {"length", "$strlen", 1, SDB_FUNC_LENGTH},
+    {"substr", "$substr", 3, SDB_FUNC_SUBSTR},
+    {"cast_as_date", NULL, 1, SDB_FUNC_DATE},
+    {"year", NULL, 1, SDB_FUNC_YEAR}};
+
+static const Sdb_func_map *sdb_get_func_map(Item_func *func) {
+  const char *func_name = func->func_name();
+  for (uint i = 0; i < array_elements(SDB_FUNC_MAPS); ++i) {
+    if (0 == strcmp(SDB_FUNC_MAPS[i].func_name, func_name) &&
+        SDB_FUNC_MAPS[i].arg_count == func->argument_count()) {
+      return &SDB_FUNC_MAPS[i];
+    }
+  }
+  return NULL;
+}
+
+static bool sdb_is_string_field(Field *field) {
+  switch (field->type()) {
+    case MYSQL_TYPE_VARCHAR:
+    case MYSQL_TYPE_VAR_STRING:
+    case MYSQL_TYPE_STRING:
+    case MYSQL_TYPE_TINY_BLOB:
+    case MYSQL_TYPE_MEDIUM_BLOB:
+    case MYSQL_TYPE_LONG_BLOB:
+    case MYSQL_TYPE_BLOB:
+      return !field->binary();
+    default:
+      return false;
+  }
+}
+
+/*
+  The string functions of SequoiaDB work on bytes, while those of MySQL work
+  on characters of the column charset. Strings are stored in utf8mb4, so the
+  two only agree when every character is one byte in both, which is true for
+  the pure ASCII charsets. latin1 is converted to multibyte utf8mb4.
+*/
+static bool sdb_is_single_byte_field(Field *field) {
+  const CHARSET_INFO *cs = field->charset();
+  return 1 == cs->mbmaxlen && (cs->state & MY_CS_PUREASCII);
+}
+
+static bool sdb_is_const_value(Item *item) {
+  if (NULL == item || !item->const_item() ||
+      Item::NULL_ITEM == item->type()) {
+    return false;
+  }
+  // don't push down the triggered conditions or the func will be
+  // triggered in push down one more time
+  if (Item::FUNC_ITEM == item->type() &&
+      (((Item_func *)item)->functype() == Item_func::FUNC_SP ||
+       ((Item_func *)item)->functype() == Item_func::TRIG_COND_FUNC)) {
+    return false;
+  }
+  return true;
+}
+
+// Append the time value in the same format as the field is stored.
+static int sdb_append_time(const char *op_str, MYSQL_TIME *ltime, Field *field,
+                           bson::BSONObjBuilder &builder) {
+  int rc = SDB_ERR_OK;
+  switch (field->type()) {
+    case MYSQL_TYPE_DATE: {
+      struct tm tm_val;
+      tm_val.tm_sec = 0;
+      tm_val.tm_min = 0;
+      tm_val.tm_hour = 0;
+      tm_val.tm_mday = ltime->day;
+      tm_val.tm_mon = ltime->month - 1;
+      tm_val.tm_year = ltime->year - 1900;
+      tm_val.tm_wday = 0;
+      tm_val.tm_yday = 0;
+      tm_val.tm_isdst = 0;
+      time_t time_tmp = mktime(&tm_val);
+      bson::Date_t dt((longlong)(time_tmp * 1000));
+      builder.appendDate(op_str, dt);
+      break;
+    }
+    case MYSQL_TYPE_DATETIME: {
+      uint dec = field->decimals();
+      char buff[MAX_FIELD_WIDTH];
+      if (ltime->year > 9999 || ltime->year < 1000) {
+        rc = SDB_ERR_COND_UNEXPECTED_ITEM;
+        goto error;
+      }
+      int len = sprintf(buff, "%04u-%02u-%02u %02u:%02u:%02u", ltime->year,
+                        ltime->month, ltime->day, ltime->hour, ltime->minute,
+                        ltime->second);
+      if (dec) {
+        len += sprintf(buff + len, ".%0*lu", (int)dec, ltime->second_part);
+      }
+      builder.append(op_str, buff);
+      break;
+    }
+    case MYSQL_TYPE_TIMESTAMP: {
+      struct timeval tm;
+      int warnings = 0;
+      if (datetime_to_timeval(current_thd, ltime, &tm, &warnings)) {
+        rc = SDB_ERR_COND_UNEXPECTED_ITEM;
+        goto error;
+      }
+      bson::OpTime t(tm.tv_sec, tm.tv_usec);
+      builder.appendTimestamp(op_str, t.asDate());
+      break;
+    }
+    default: {
+      rc = SDB_ERR_COND_UNEXPECTED_ITEM;
+      goto error;
+    }
+  }
+
+done:
+  return rc;
+error:
+  goto done;
+}
+
 // This function is similar to Item::get_timeval() but return true if value is
 // out of the supported range.
 static bool get_timeval(Item *item, struct timeval *tm) {
@@ -79,6 +225,15 @@ int Sdb_logic_item::push_sdb_item(Sdb_item *cond_item) {
     is_ok = FALSE;
     goto error;
   }
+  if (!cond_item->exact()) {
+    is_exact = FALSE;
+  }
+  if (cond_item->null_safe()) {
+    is_null_safe = TRUE;
+  }
+  if (cond_item->may_be_null_negated()) {
+    is_null_negated = TRUE;
+  }
   delete cond_item;
   children.append(obj_tmp);
 
@@ -111,6 +266,290 @@ int Sdb_and_item::to_bson(bson::BSONObj &obj) {
   return SDB_ERR_OK;
 }
 
+struct Sdb_inverse_op {
+  const char *op;
+  const char *inverse_op;
+  bool exclude_null;  // NULL matches the inverse op but not the negation
+};
+
+static const Sdb_inverse_op SDB_INVERSE_OPS[] = {
+    {"$et", "$ne", true},   {"$ne", "$et", false},  {"$lt", "$gte", false},
+    {"$lte", "$gt", false}, {"$gt", "$lte", false}, {"$gte", "$lt", false},
+    {"$in", "$nin", true},  {"$nin", "$in", false}};
+
+static const Sdb_inverse_op *sdb_get_inverse_op(const char *op) {
+  for (uint i = 0; i < array_elements(SDB_INVERSE_OPS); ++i) {
+    if (0 == strcmp(SDB_INVERSE_OPS[i].op, op)) {
+      return &SDB_INVERSE_OPS[i];
+    }
+  }
+  return NULL;
+}
+
+static int sdb_negate_cond(const bson::BSONObj &cond, bson::BSONObj &obj);
+
+/*
+  Negate one element of the matcher in the three-valued logic of MySQL, that
+  is, the result matches the records on which the element is false but not
+  NULL. The comparisons of SequoiaDB never match NULL or missing fields,
+  so `a < 1` is negated into `a >= 1`, while `a = 1` is negated into
+  `a != 1 AND a IS NOT NULL`.
+*/
+static int sdb_negate_elem(const bson::BSONElement &elem,
+                           bson::BSONObj &obj) {
+  int rc = SDB_ERR_OK;
+  const char *name = elem.fieldName();
+  const Sdb_inverse_op *inverse = NULL;
+  bson::BSONElement op_elem;
+  bson::BSONArrayBuilder arr_builder;
+  bson::BSONObjBuilder builder;
+  bson::BSONObj neg_obj;
+
+  if (0 == strcmp(name, "$and") || 0 == strcmp(name, "$or")) {
+    // De Morgan's laws also hold in the three-valued logic
+    bson::BSONObjIterator iter(elem.embeddedObject());
+    while (iter.more()) {
+      rc = sdb_negate_cond(iter.next().embeddedObject(), neg_obj);
+      if (rc) {
+        goto error;
+      }
+      arr_builder.append(neg_obj);
+    }
+    obj = BSON((0 == strcmp(name, "$and") ? "$or" : "$and")
+               << arr_builder.arr());
+    goto done;
+  }
+
+  if (0 == strcmp(name, "$not")) {
+    // $not is never NULL, so its negation is the condition itself
+    builder.appendArray("$and", elem.embeddedObject());
+    obj = builder.obj();
+    goto done;
+  }
+
+  if ('$' == name[0]) {
+    rc = SDB_ERR_COND_UNSUPPORTED;
+    goto error;
+  }
+
+  if (bson::Object != elem.type()) {
+    // {a: 1} or {a: /regex/}
+    if (bson::RegEx == elem.type()) {
+      builder.append(elem);
+      neg_obj = BSON("$not" << BSON_ARRAY(builder.obj()));
+    } else {
+      builder.appendAs(elem, "$ne");
+      neg_obj = BSON(name << builder.obj());
+    }
+    obj = BSON("$and" << BSON_ARRAY(neg_obj << BSON(
+                                        name << BSON("$isnull" << 0))));
+    goto done;
+  }
+
+  {
+    bson::BSONObjIterator iter(elem.embeddedObject());
+    while (iter.more()) {
+      op_elem = iter.next();
+      // comparing with another field by $field may be NULL on both sides,
+      // and $exists is not a predicate of the value
+      if (bson::Object == op_elem.type() ||
+          0 == strcmp(op_elem.fieldName(), "$exists")) {
+        rc = SDB_ERR_COND_UNSUPPORTED;
+        goto error;
+      }
+    }
+  }
+
+  op_elem = elem.embeddedObject().firstElement();
+  if (1 == elem.embeddedObject().nFields()) {
+    if (0 == strcmp(op_elem.fieldName(), "$isnull")) {
+      obj = BSON(name << BSON("$isnull" << (op_elem.numberInt() ? 0 : 1)));
+      goto done;
+    }
+    inverse = sdb_get_inverse_op(op_elem.fieldName());
+  }
+
+  if (inverse != NULL) {
+    builder.appendAs(op_elem, inverse->inverse_op);
+    neg_obj = BSON(name << builder.obj());
+    if (!inverse->exclude_null) {
+      obj = neg_obj;
+      goto done;
+    }
+  } else {
+    // functional operators such as {a: {$upper: 1, $et: 'A'}}
+    builder.append(elem);
+    neg_obj = BSON("$not" << BSON_ARRAY(builder.obj()));
+  }
+  obj = BSON("$and" << BSON_ARRAY(neg_obj
+                                  << BSON(name << BSON("$isnull" << 0))));
+
+done:
+  return rc;
+error:
+  goto done;
+}
+
+// The elements of the matcher are ANDed, so the negation is ORed.
+static int sdb_negate_cond(const bson::BSONObj &cond, bson::BSONObj &obj) {
+  int rc = SDB_ERR_OK;
+  bson::BSONArrayBuilder arr_builder;
+  bson::BSONObjIterator iter(cond);
+  bson::BSONObj neg_obj;
+
+  if (cond.isEmpty()) {
+    rc = SDB_ERR_COND_UNSUPPORTED;
+    goto error;
+  }
+
+  if (1 == cond.nFields()) {
+    rc = sdb_negate_elem(cond.firstElement(), obj);
+    goto done;
+  }
+
+  while (iter.more()) {
+    rc = sdb_negate_elem(iter.next(), neg_obj);
+    if (rc) {
+      goto error;
+    }
+    arr_builder.append(neg_obj);
+  }
+  obj = BSON("$or" << arr_builder.arr());
+
+done:
+  return rc;
+error:
+  goto done;
+}
+
+int Sdb_not_item::push_sdb_item(Sdb_item *cond_item) {
+  int rc = SDB_ERR_OK;
+
+  if (is_finished) {
+    rc = SDB_ERR_COND_UNEXPECTED_ITEM;
+    goto error;
+  }
+
+  rc = cond_item->to_bson(child);
+  if (rc != 0) {
+    goto error;
+  }
+
+  // the negation of a partial condition would filter out matched records
+  if (!cond_item->exact()) {
+    rc = SDB_ERR_COND_UNSUPPORTED;
+    goto error;
+  }
+  // NOT(a <=> 1) matches the records on which a is NULL
+  if (negated && cond_item->null_safe()) {
+    rc = SDB_ERR_COND_UNSUPPORTED;
+    goto error;
+  }
+  // NOT(a=1 XOR b=1) would turn the NULL guards into `$isnull: 1`
+  if (negated && cond_item->may_be_null_negated()) {
+    rc = SDB_ERR_COND_UNSUPPORTED;
+    goto error;
+  }
+  child_null_safe = cond_item->null_safe();
+  delete cond_item;
+  is_finished = TRUE;
+
+done:
+  return rc;
+error:
+  goto done;
+}
+
+int Sdb_not_item::to_bson(bson::BSONObj &obj) {
+  int rc = SDB_ERR_OK;
+  bson::BSONObj cond;
+
+  if (!is_finished) {
+    rc = SDB_ERR_COND_INCOMPLETED;
+    goto error;
+  }
+
+  cond = child;
+  if (negated) {
+    rc = sdb_negate_cond(child, cond);
+    if (rc != 0) {
+      goto error;
+    }
+  }
+
+  if (not_true) {
+    // $not matches the records on which cond is false or NULL
+    obj = BSON(this->name() << BSON_ARRAY(cond));
+  } else {
+    obj = cond;
+  }
+
+done:
+  return rc;
+error:
+  goto done;
+}
+
+int Sdb_xor_item::push_sdb_item(Sdb_item *cond_item) {
+  int rc = SDB_ERR_OK;
+
+  if (is_finished) {
+    rc = SDB_ERR_COND_UNEXPECTED_ITEM;
+    goto error;
+  }
+
+  rc = cond_item->to_bson(children[child_num]);
+  if (rc != 0) {
+    goto error;
+  }
+
+  // each child is negated in to_bson(), see Sdb_not_item::push_sdb_item()
+  if (!cond_item->exact() || cond_item->null_safe() ||
+      cond_item->may_be_null_negated()) {
+    rc = SDB_ERR_COND_UNSUPPORTED;
+    goto error;
+  }
+  delete cond_item;
+  if (++child_num >= 2) {
+    is_finished = TRUE;
+  }
+
+done:
+  return rc;
+error:
+  goto done;
+}
+
+int Sdb_xor_item::to_bson(bson::BSONObj &obj) {
+  int rc = SDB_ERR_OK;
+  bson::BSONObj neg_left;
+  bson::BSONObj neg_right;
+
+  if (!is_finished) {
+    rc = SDB_ERR_COND_INCOMPLETED;
+    goto error;
+  }
+
+  // a XOR b => (a AND NOT b) OR (NOT a AND b). It is NULL if a or b is NULL,
+  // and neither of a and NOT a matches NULL.
+  rc = sdb_negate_cond(children[0], neg_left);
+  if (rc != 0) {
+    goto error;
+  }
+  rc = sdb_negate_cond(children[1], neg_right);
+  if (rc != 0) {
+    goto error;
+  }
+  obj = BSON("$or" << BSON_ARRAY(
+                 BSON("$and" << BSON_ARRAY(children[0] << neg_right))
+                 << BSON("$and" << BSON_ARRAY(neg_left << children[1]))));
+
+done:
+  return rc;
+error:
+  goto done;
+}
+
 Sdb_func_item::Sdb_func_item() : para_num_cur(0), para_num_max(1) {
   l_child = NULL;
   r_child = NULL;
@@ -676,7 +1115,6 @@ int Sdb_func_cmp::to_bson_with_child(bson::BSONObj &obj) {
   }
 
   if (child->type() != Item_func::UNKNOWN_FUNC || !child->finished() ||
-      ((Sdb_func_item *)child)->get_para_num() != 2 ||
       this->get_para_num() != 2) {
     rc = SDB_ERR_COND_UNEXPECTED_ITEM;
     goto error;
@@ -688,7 +1126,20 @@ int Sdb_func_cmp::to_bson_with_child(bson::BSONObj &obj) {
     goto error;
   }
   func = (Item_func *)item_tmp;
-  if (func->functype() != Item_func::UNKNOWN_FUNC) {
+
+  if (NULL != sdb_get_func_map(func)) {
+    // func(field, ...) < num
+    rc = to_bson_with_func(
+        func, sdb_func, (cmp_inverse ? this->inverse_name() : this->name()),
+        obj);
+    if (rc != SDB_ERR_OK) {
+      goto error;
+    }
+    goto done;
+  }
+
+  if (sdb_func->get_para_num() != 2 ||
+      func->functype() != Item_func::UNKNOWN_FUNC) {
     rc = SDB_ERR_COND_UNEXPECTED_ITEM;
     goto error;
   }
@@ -880,6 +1331,227 @@ error:
   goto done;
 }
 
+int Sdb_func_cmp::to_bson_with_func(Item_func *func, Sdb_func_unkown *sdb_func,
+                                    const char *op_str, bson::BSONObj &obj) {
+  int rc = SDB_ERR_OK;
+  const Sdb_func_map *func_map = sdb_get_func_map(func);
+  Item *args[3] = {NULL, NULL, NULL};
+  Item *item_val = NULL;
+  Item_field *item_field = NULL;
+  Field *field = NULL;
+  bson::BSONObj obj_tmp;
+  bson::BSONObjBuilder builder_tmp;
+
+  DBUG_ASSERT(NULL != func_map);
+  DBUG_ASSERT(func_map->arg_count <= array_elements(args));
+
+  for (uint i = 0; i < func_map->arg_count; ++i) {
+    if (sdb_func->pop_item(args[i])) {
+      // nested function is not supported, such as UPPER(TRIM(a))
+      rc = SDB_ERR_COND_UNEXPECTED_ITEM;
+      goto error;
+    }
+  }
+  item_val = para_list.pop();
+
+  if (Item::FIELD_ITEM != args[0]->type() || args[0]->const_item() ||
+      !sdb_is_const_value(item_val)) {
+    rc = SDB_ERR_COND_UNEXPECTED_ITEM;
+    goto error;
+  }
+  item_field = (Item_field *)args[0];
+  field = item_field->field;
+
+  switch (func_map->kind) {
+    case SDB_FUNC_STRING: {
+      // {a: {$upper: 1, $et: "X"}}
+      if (!sdb_is_string_field(field) || !sdb_is_single_byte_field(field)) {
+        rc = SDB_ERR_COND_UNEXPECTED_ITEM;
+        goto error;
+      }
+      builder_tmp.append(func_map->sdb_op, 1);
+      rc = get_item_val(op_str, item_val, field, obj_tmp);
+      if (rc != SDB_ERR_OK) {
+        goto error;
+      }
+      builder_tmp.appendElements(obj_tmp);
+      break;
+    }
+    case SDB_FUNC_LENGTH: {
+      // {a: {$strlen: 1, $et: 3}}
+      // LENGTH() returns the length in bytes, which only equals to the
+      // length stored in SequoiaDB when no charset conversion happens.
+      if (!sdb_is_string_field(field) ||
+          !my_charset_same(field->charset(), &SDB_CHARSET) ||
+          INT_RESULT != item_val->result_type()) {
+        rc = SDB_ERR_COND_UNEXPECTED_ITEM;
+        goto error;
+      }
+      longlong len = item_val->val_int();
+      if (item_val->null_value) {
+        rc = SDB_ERR_COND_UNEXPECTED_ITEM;
+        goto error;
+      }
+      builder_tmp.append(func_map->sdb_op, 1);
+      builder_tmp.append(op_str, len);
+      break;
+    }
+    case SDB_FUNC_SUBSTR: {
+      // SUBSTRING(a, 1, 3) = "abc" => {a: {$substr: [0, 3], $et: "abc"}}
+      // The start position of SequoiaDB begins from 0.
+      if (!sdb_is_string_field(field) || !sdb_is_single_byte_field(field) ||
+          !sdb_is_const_value(args[1]) || !sdb_is_const_value(args[2]) ||
+          INT_RESULT != args[1]->result_type() ||
+          INT_RESULT != args[2]->result_type()) {
+        rc = SDB_ERR_COND_UNEXPECTED_ITEM;
+        goto error;
+      }
+      longlong start = args[1]->val_int();
+      longlong len = args[2]->val_int();
+      if (args[1]->null_value || args[2]->null_value || start < 1 ||
+          start > INT_MAX32 || len < 0 || len > INT_MAX32) {
+        rc = SDB_ERR_COND_UNEXPECTED_ITEM;
+        goto error;
+      }
+      builder_tmp.append(func_map->sdb_op,
+                         BSON_ARRAY((int)(start - 1) << (int)len));
+      rc = get_item_val(op_str, item_val, field, obj_tmp);
+      if (rc != SDB_ERR_OK) {
+        goto error;
+      }
+      builder_tmp.appendElements(obj_tmp);
+      break;
+    }
+    case SDB_FUNC_DATE:
+    case SDB_FUNC_YEAR: {
+      rc = to_bson_with_date_part(func, item_field, item_val, op_str, obj);
+      if (rc != SDB_ERR_OK) {
+        goto error;
+      }
+      goto done;
+    }
+    default: {
+      rc = SDB_ERR_COND_UNEXPECTED_ITEM;
+      goto error;
+    }
+  }
+  obj = BSON(item_field->field_name << builder_tmp.obj());
+
+done:
+  return rc;
+error:
+  goto done;
+}
+
+/*
+  Rewrite the comparison of DATE(a) or YEAR(a) into a range of the column
+  itself, so that SequoiaDB can use the index on it. [low, high) is the range
+  of the column that DATE(a) or YEAR(a) equals to the constant:
+
+    DATE(a) = d   =>   a >= d AND a < d + 1
+    DATE(a) < d   =>   a < d
+    DATE(a) <= d  =>   a < d + 1
+    DATE(a) > d   =>   a >= d + 1
+    DATE(a) >= d  =>   a >= d
+*/
+int Sdb_func_cmp::to_bson_with_date_part(Item_func *func,
+                                         Item_field *item_field,
+                                         Item *item_val, const char *op_str,
+                                         bson::BSONObj &obj) {
+  int rc = SDB_ERR_OK;
+  const Sdb_func_map *func_map = sdb_get_func_map(func);
+  Field *field = item_field->field;
+  MYSQL_TIME low, high;
+  bson::BSONObjBuilder low_builder;
+  bson::BSONObjBuilder high_builder;
+  bson::BSONArrayBuilder arr_builder;
+
+  if (MYSQL_TYPE_DATE != field->type() &&
+      MYSQL_TYPE_DATETIME != field->type() &&
+      MYSQL_TYPE_TIMESTAMP != field->type()) {
+    rc = SDB_ERR_COND_UNEXPECTED_ITEM;
+    goto error;
+  }
+
+  set_zero_time(&low, MYSQL_TIMESTAMP_DATETIME);
+  set_zero_time(&high, MYSQL_TIMESTAMP_DATETIME);
+  if (SDB_FUNC_DATE == func_map->kind) {
+    MYSQL_TIME ltime;
+    if (item_val->get_date(&ltime, TIME_FUZZY_DATE) || item_val->null_value ||
+        0 == ltime.month || 0 == ltime.day) {
+      rc = SDB_ERR_COND_UNEXPECTED_ITEM;
+      goto error;
+    }
+    // DATE(a) = '2019-01-01 12:00:00' is always false, leave it to MySQL.
+    if (ltime.hour || ltime.minute || ltime.second || ltime.second_part) {
+      rc = SDB_ERR_COND_UNEXPECTED_ITEM;
+      goto error;
+    }
+    low.year = ltime.year;
+    low.month = ltime.month;
+    low.day = ltime.day;
+    get_date_from_daynr(calc_daynr(low.year, low.month, low.day) + 1,
+                        &high.year, &high.month, &high.day);
+  } else {
+    if (INT_RESULT != item_val->result_type()) {
+      rc = SDB_ERR_COND_UNEXPECTED_ITEM;
+      goto error;
+    }
+    longlong year = item_val->val_int();
+    if (item_val->null_value || year < 1000 || year >= 9999) {
+      rc = SDB_ERR_COND_UNEXPECTED_ITEM;
+      goto error;
+    }
+    low.year = (uint)year;
+    low.month = 1;
+    low.day = 1;
+    high.year = (uint)year + 1;
+    high.month = 1;
+    high.day = 1;
+  }
+
+  if (0 == strcmp("$et", op_str)) {
+    rc = sdb_append_time("$gte", &low, field, low_builder);
+    if (rc != SDB_ERR_OK) {
+      goto error;
+    }
+    rc = sdb_append_time("$lt", &high, field, high_builder);
+    if (rc != SDB_ERR_OK) {
+      goto error;
+    }
+    arr_builder.append(BSON(item_field->field_name << low_builder.obj()));
+    arr_builder.append(BSON(item_field->field_name << high_builder.obj()));
+    obj = BSON("$and" << arr_builder.arr());
+  } else if (0 == strcmp("$lt", op_str) || 0 == strcmp("$gte", op_str)) {
+    rc = sdb_append_time(op_str, &low, field, low_builder);
+    if (rc != SDB_ERR_OK) {
+      goto error;
+    }
+    obj = BSON(item_field->field_name << low_builder.obj());
+  } else if (0 == strcmp("$lte", op_str)) {
+    rc = sdb_append_time("$lt", &high, field, high_builder);
+    if (rc != SDB_ERR_OK) {
+      goto error;
+    }
+    obj = BSON(item_field->field_name << high_builder.obj());
+  } else if (0 == strcmp("$gt", op_str)) {
+    rc = sdb_append_time("$gte", &high, field, high_builder);
+    if (rc != SDB_ERR_OK) {
+      goto error;
+    }
+    obj = BSON(item_field->field_name << high_builder.obj());
+  } else {
+    // DATE(a) != d is not a range
+    rc = SDB_ERR_COND_UNEXPECTED_ITEM;
+    goto error;
+  }
+
+done:
+  return rc;
+error:
+  goto done;
+}
+
 int Sdb_func_cmp::to_bson(bson::BSONObj &obj) {
   int rc = SDB_ERR_OK;
   bool inverse = FALSE;
@@ -1072,12 +1744,25 @@ Sdb_func_in::Sdb_func_in(bool has_not, uint args_num) : Sdb_func_neg(has_not) {
 
 Sdb_func_in::~Sdb_func_in() {}
 
+static bool sdb_bson_elem_less(const bson::BSONElement &left,
+                               const bson::BSONElement &right) {
+  return left.woCompare(right, false) < 0;
+}
+
+static bool sdb_bson_elem_equal(const bson::BSONElement &left,
+                                const bson::BSONElement &right) {
+  return 0 == left.woCompare(right, false);
+}
+
 int Sdb_func_in::to_bson(bson::BSONObj &obj) {
   int rc = SDB_ERR_OK;
   Item_field *item_field = NULL;
   Item *item_tmp = NULL;
   bson::BSONArrayBuilder arr_builder;
+  bson::BSONArrayBuilder sorted_builder;
   bson::BSONObj obj_tmp;
+  bson::BSONObj values;
+  std::vector<bson::BSONElement> elems;
 
   if (!is_finished || para_list.elements != para_num_max) {
     rc = SDB_ERR_COND_INCOMPLETED;
@@ -1089,6 +1774,12 @@ int Sdb_func_in::to_bson(bson::BSONObj &obj) {
     goto error;
   }
 
+  // the first argument is the field
+  if (para_num_max - 1 > SDB_MATCH_IN_NUM_MAX) {
+    rc = SDB_ERR_COND_UNSUPPORTED;
+    goto error;
+  }
+
   item_tmp = para_list.pop();
   if (Item::FIELD_ITEM != item_tmp->type()) {
     rc = SDB_ERR_COND_UNEXPECTED_ITEM;
@@ -1104,10 +1795,26 @@ int Sdb_func_in::to_bson(bson::BSONObj &obj) {
     }
   }
 
+  // Large IN lists often have duplicated values. Send the distinct values in
+  // order, which keeps the matcher small and lets the server search in it.
+  values = arr_builder.arr();
+  {
+    bson::BSONObjIterator iter(values);
+    while (iter.more()) {
+      elems.push_back(iter.next());
+    }
+  }
+  std::sort(elems.begin(), elems.end(), sdb_bson_elem_less);
+  elems.erase(std::unique(elems.begin(), elems.end(), sdb_bson_elem_equal),
+              elems.end());
+  for (uint i = 0; i < elems.size(); ++i) {
+    sorted_builder.append(elems[i]);
+  }
+
   if (negated) {
-    obj = BSON(item_field->field_name << BSON("$nin" << arr_builder.arr()));
+    obj = BSON(item_field->field_name << BSON("$nin" << sorted_builder.arr()));
   } else {
-    obj = BSON(item_field->field_name << BSON("$in" << arr_builder.arr()));
+    obj = BSON(item_field->field_name << BSON("$in" << sorted_builder.arr()));
   }
 
 done:
@@ -1131,6 +1838,8 @@ int Sdb_func_like::to_bson(bson::BSONObj &obj) {
   String *str_val_org;
   String str_val_conv;
   std::string regex_val;
+  std::string prefix;
+  bool only_prefix = false;
   bson::BSONObjBuilder regex_builder;
 
   if (!is_finished || para_list.elements != para_num_max) {
@@ -1191,10 +1900,50 @@ int Sdb_func_like::to_bson(bson::BSONObj &obj) {
     goto error;
   }
 
+  // The range is ordered by bytes, which only the _bin collations follow.
+  // The others, like utf8mb4_general_ci, keep the regex.
+  if (item_field->field->charset()->state & MY_CS_BINSORT) {
+    get_prefix_range(str_val_conv.ptr(), str_val_conv.length(), prefix,
+                     only_prefix);
+  }
+
   if (regex_val.empty()) {
     // select * from t1 where a like "";
     // => {a:""}
     obj = BSON(item_field->field_name << regex_val);
+  } else if (!prefix.empty()) {
+    // select * from t1 where a like "abc%";
+    // => {$and:[{a:{$gte:"abc"}}, {a:{$lt:"abd"}}]}
+    // The regex is appended only if there are other wildcards after the
+    // prefix, such as "abc%d_".
+    std::string upper_bound = prefix;
+    bson::BSONObjBuilder low_builder;
+    bson::BSONArrayBuilder arr_builder;
+
+    low_builder.appendStrWithNoTerminating("$gte", prefix.data(),
+                                           prefix.length());
+    arr_builder.append(BSON(item_field->field_name << low_builder.obj()));
+
+    // SequoiaDB compares strings byte by byte, so the smallest string
+    // greater than all strings with the prefix is the prefix with the last
+    // byte increased. If all bytes are 0xFF, there is no upper bound.
+    while (!upper_bound.empty() &&
+           (uchar)upper_bound[upper_bound.length() - 1] == 0xFF) {
+      upper_bound.erase(upper_bound.length() - 1);
+    }
+    if (!upper_bound.empty()) {
+      bson::BSONObjBuilder high_builder;
+      upper_bound[upper_bound.length() - 1]++;
+      high_builder.appendStrWithNoTerminating("$lt", upper_bound.data(),
+                                              upper_bound.length());
+      arr_builder.append(BSON(item_field->field_name << high_builder.obj()));
+    }
+
+    if (!only_prefix) {
+      regex_builder.appendRegex(item_field->field_name, regex_val, "s");
+      arr_builder.append(regex_builder.obj());
+    }
+    obj = BSON("$and" << arr_builder.arr());
   } else {
     regex_builder.appendRegex(item_field->field_name, regex_val, "s");
     obj = regex_builder.obj();
@@ -1206,6 +1955,52 @@ error:
   goto done;
 }
 
+/*
+  Get the literal prefix before the first wildcard of the like string.
+  The prefix is empty if the like string begins with a wildcard or has no
+  wildcard at all. `only_prefix` is true if the like string is a prefix
+  followed by '%' only, such as "abc%".
+*/
+void Sdb_func_like::get_prefix_range(const char *like_str, size_t len,
+                                     std::string &prefix, bool &only_prefix) {
+  const char *p_cur = like_str;
+  const char *p_end = like_str + len;
+  int escape_char = like_item->escape;
+
+  prefix = "";
+  only_prefix = false;
+
+  while (p_cur < p_end) {
+    if (escape_char == *p_cur && p_cur + 1 < p_end) {
+      prefix.append(p_cur + 1, 1);
+      p_cur += 2;
+      continue;
+    }
+    if ('%' == *p_cur || '_' == *p_cur) {
+      break;
+    }
+    prefix.append(p_cur, 1);
+    ++p_cur;
+  }
+
+  if (p_cur == p_end) {
+    // no wildcard, it's not a prefix
+    prefix = "";
+    goto done;
+  }
+
+  only_prefix = true;
+  for (; p_cur < p_end; ++p_cur) {
+    if ('%' != *p_cur) {
+      only_prefix = false;
+      break;
+    }
+  }
+
+done:
+  return;
+}
+
 int Sdb_func_like::get_regex_str(const char *like_str, size_t len,
                                  std::string &regex_str) {
   int rc = SDB_ERR_OK;
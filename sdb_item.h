@@ -36,6 +36,19 @@ class Sdb_item : public Sql_alloc {
   virtual const char *name() = 0;
   virtual bool finished() { return is_finished; };
 
+  // Whether to_bson() matches exactly the records of the condition. $and
+  // may match more records when some children can't be pushed down, and
+  // such a condition can't be negated.
+  virtual bool exact() { return true; }
+
+  // Whether the condition is never NULL, like `a <=> 1`. Its negation
+  // matches NULL, which sdb_negate_cond() can't express.
+  virtual bool null_safe() { return false; }
+
+  // Whether to_bson() may contain the `$isnull: 0` guards added by
+  // sdb_negate_cond(). Negating it again would turn them into `$isnull: 1`.
+  virtual bool may_be_null_negated() { return false; }
+
   virtual Item_func::Functype type() = 0;
 
  protected:
@@ -44,16 +57,27 @@ class Sdb_item : public Sql_alloc {
 
 class Sdb_logic_item : public Sdb_item {
  public:
-  Sdb_logic_item() { is_ok = TRUE; }
+  Sdb_logic_item() {
+    is_ok = TRUE;
+    is_exact = TRUE;
+    is_null_safe = FALSE;
+    is_null_negated = FALSE;
+  }
   virtual int push_sdb_item(Sdb_item *cond_item);
   virtual int push_item(Item *cond_item);
   virtual int to_bson(bson::BSONObj &obj);
   virtual const char *name() = 0;
+  virtual bool exact() { return is_ok && is_exact; }
+  virtual bool null_safe() { return is_null_safe; }
+  virtual bool may_be_null_negated() { return is_null_negated; }
   virtual Item_func::Functype type() = 0;
 
  protected:
   bson::BSONArrayBuilder children;
   bool is_ok;
+  bool is_exact;
+  bool is_null_safe;
+  bool is_null_negated;
 };
 
 class Sdb_and_item : public Sdb_logic_item {
@@ -75,6 +99,51 @@ class Sdb_or_item : public Sdb_logic_item {
   virtual const char *name() { return "$or"; }
 };
 
+/*
+  NOT and the truth tests. The negation follows the three-valued logic of
+  MySQL: NOT(a = 1) is not true when a is NULL, while `a = 1 IS NOT TRUE` is.
+
+  NOT(c), c IS FALSE:       negated = TRUE, not_true = FALSE
+  c IS TRUE:                negated = FALSE, not_true = FALSE
+  c IS NOT TRUE:            negated = FALSE, not_true = TRUE
+  c IS NOT FALSE:           negated = TRUE, not_true = TRUE
+*/
+class Sdb_not_item : public Sdb_item {
+ public:
+  Sdb_not_item(bool is_negated, bool is_not_true)
+      : negated(is_negated), not_true(is_not_true), child_null_safe(false) {}
+  virtual ~Sdb_not_item() {}
+
+  virtual int push_sdb_item(Sdb_item *cond_item);
+  virtual int to_bson(bson::BSONObj &obj);
+  virtual bool null_safe() { return child_null_safe; }
+  virtual bool may_be_null_negated() { return true; }
+  virtual Item_func::Functype type() { return Item_func::NOT_FUNC; }
+  virtual const char *name() { return "$not"; }
+
+ private:
+  bson::BSONObj child;
+  bool negated;
+  bool not_true;
+  bool child_null_safe;
+};
+
+class Sdb_xor_item : public Sdb_item {
+ public:
+  Sdb_xor_item() : child_num(0) {}
+  virtual ~Sdb_xor_item() {}
+
+  virtual int push_sdb_item(Sdb_item *cond_item);
+  virtual int to_bson(bson::BSONObj &obj);
+  virtual bool may_be_null_negated() { return true; }
+  virtual Item_func::Functype type() { return Item_func::XOR_FUNC; }
+  virtual const char *name() { return "xor"; }
+
+ private:
+  bson::BSONObj children[2];
+  uint child_num;
+};
+
 class Sdb_func_item : public Sdb_item {
  public:
   Sdb_func_item();
@@ -171,6 +240,13 @@ class Sdb_func_cmp : public Sdb_func_bin_op {
   virtual const char *name() = 0;
   virtual const char *inverse_name() = 0;
   virtual Item_func::Functype type() = 0;
+
+ private:
+  int to_bson_with_func(Item_func *func, Sdb_func_unkown *sdb_func,
+                        const char *op_str, bson::BSONObj &obj);
+  int to_bson_with_date_part(Item_func *func, Item_field *item_field,
+                             Item *item_val, const char *op_str,
+                             bson::BSONObj &obj);
 };
 
 class Sdb_func_eq : public Sdb_func_cmp {
@@ -181,6 +257,9 @@ class Sdb_func_eq : public Sdb_func_cmp {
   virtual const char *name() { return "$et"; }
   virtual const char *inverse_name() { return "$et"; }
   virtual Item_func::Functype type() { return func_item->functype(); }
+  virtual bool null_safe() {
+    return Item_func::EQUAL_FUNC == func_item->functype();
+  }
 
  private:
   Item_func *func_item;
@@ -283,6 +362,8 @@ class Sdb_func_like : public Sdb_func_bin_op {
 
  private:
   int get_regex_str(const char *like_str, size_t len, std::string &regex_str);
+  void get_prefix_range(const char *like_str, size_t len, std::string &prefix,
+                        bool &only_prefix);
 
  private:
   Item_func_like *like_item;
@@ -0,0 +1,336 @@
+/* Copyright (c) 2019, SequoiaDB and/or its affiliates. All rights reserved.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#ifndef MYSQL_SERVER
+#define MYSQL_SERVER
+#endif
+
+#include "sdb_stat.h"
+#include <sql_class.h>
+#include <my_atomic.h>
+#include <time.h>
+#include "sdb_cl.h"
+#include "sdb_conf.h"
+#include "sdb_log.h"
+#include "sdb_thd.h"
+
+#ifndef CPU_LEVEL1_DCACHE_LINESIZE
+#define CPU_LEVEL1_DCACHE_LINESIZE 64
+#endif
+
+#define SDB_STAT_SHARD_NUM 64
+
+struct Sdb_stat_shard {
+  volatile int64 counters[SDB_STAT_COUNTER_NUM];
+  char pad[CPU_LEVEL1_DCACHE_LINESIZE];
+};
+
+static Sdb_stat_shard sdb_stat_shards[SDB_STAT_SHARD_NUM];
+
+// Summary of all shards, refreshed on SHOW STATUS. Concurrent refreshes
+// may interleave, which only mixes sums taken a moment apart.
+static longlong sdb_stat_values[SDB_STAT_COUNTER_NUM];
+
+void sdb_stat_add(my_thread_id tid, SDB_STAT_COUNTER counter, longlong value) {
+  Sdb_stat_shard &shard = sdb_stat_shards[tid % SDB_STAT_SHARD_NUM];
+  my_atomic_add64(&shard.counters[counter], value);
+}
+
+#define SDB_STAT_VAR(name, counter)                                      \
+  {                                                                      \
+    name, (char *)&sdb_stat_values[counter], SHOW_LONGLONG,              \
+        SHOW_SCOPE_GLOBAL                                                \
+  }
+
+static SHOW_VAR sdb_stat_vars[] = {
+    SDB_STAT_VAR("queries", SDB_STAT_QUERIES),
+    SDB_STAT_VAR("inserts", SDB_STAT_INSERTS),
+    SDB_STAT_VAR("bulk_inserts", SDB_STAT_BULK_INSERTS),
+    SDB_STAT_VAR("updates", SDB_STAT_UPDATES),
+    SDB_STAT_VAR("deletes", SDB_STAT_DELETES),
+    SDB_STAT_VAR("trans_begins", SDB_STAT_TRANS_BEGINS),
+    SDB_STAT_VAR("trans_commits", SDB_STAT_TRANS_COMMITS),
+    SDB_STAT_VAR("trans_rollbacks", SDB_STAT_TRANS_ROLLBACKS),
+    SDB_STAT_VAR("cursor_nexts", SDB_STAT_CURSOR_NEXTS),
+    SDB_STAT_VAR("rows_received", SDB_STAT_ROWS_RECEIVED),
+    SDB_STAT_VAR("rows_sent", SDB_STAT_ROWS_SENT),
+    SDB_STAT_VAR("bytes_received", SDB_STAT_BYTES_RECEIVED),
+    SDB_STAT_VAR("bytes_sent", SDB_STAT_BYTES_SENT),
+    SDB_STAT_VAR("reconnects", SDB_STAT_RECONNECTS),
+    SDB_STAT_VAR("cond_pushed", SDB_STAT_COND_PUSHED),
+    SDB_STAT_VAR("cond_part_unsupported", SDB_STAT_COND_PART_UNSUPPORTED),
+    SDB_STAT_VAR("cond_not_pushed", SDB_STAT_COND_NOT_PUSHED),
+    SDB_STAT_VAR("stats_refreshes", SDB_STAT_STATS_REFRESHES),
+    SDB_STAT_VAR("slow_ops", SDB_STAT_SLOW_OPS),
+    {NullS, NullS, SHOW_LONG, SHOW_SCOPE_GLOBAL}};
+
+static int sdb_show_stat(THD *thd, SHOW_VAR *var, char *buff) {
+  for (int i = 0; i < SDB_STAT_COUNTER_NUM; ++i) {
+    longlong sum = 0;
+    for (int j = 0; j < SDB_STAT_SHARD_NUM; ++j) {
+      sum += my_atomic_load64(&sdb_stat_shards[j].counters[i]);
+    }
+    sdb_stat_values[i] = sum;
+  }
+
+  var->type = SHOW_ARRAY;
+  var->value = (char *)&sdb_stat_vars;
+  var->scope = SHOW_SCOPE_GLOBAL;
+  return 0;
+}
+
+// Requests and rows of the last statement which accessed SequoiaDB.
+static int sdb_show_stmt_rpcs(THD *thd, SHOW_VAR *var, char *buff) {
+  Thd_sdb *thd_sdb = thd_get_thd_sdb(thd);
+  *(longlong *)buff = (NULL != thd_sdb) ? thd_sdb->stmt_rpcs() : 0;
+  var->type = SHOW_LONGLONG;
+  var->value = buff;
+  var->scope = SHOW_SCOPE_SESSION;
+  return 0;
+}
+
+static int sdb_show_stmt_rows(THD *thd, SHOW_VAR *var, char *buff) {
+  Thd_sdb *thd_sdb = thd_get_thd_sdb(thd);
+  *(longlong *)buff = (NULL != thd_sdb) ? thd_sdb->stmt_rows() : 0;
+  var->type = SHOW_LONGLONG;
+  var->value = buff;
+  var->scope = SHOW_SCOPE_SESSION;
+  return 0;
+}
+
+// The names are prefixed with "Sequoiadb_", like Sequoiadb_queries.
+SHOW_VAR sdb_status_vars[] = {
+    {"Sequoiadb", (char *)&sdb_show_stat, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+    {"Sequoiadb_stmt_rpcs", (char *)&sdb_show_stmt_rpcs, SHOW_FUNC,
+     SHOW_SCOPE_SESSION},
+    {"Sequoiadb_stmt_rows", (char *)&sdb_show_stmt_rows, SHOW_FUNC,
+     SHOW_SCOPE_SESSION},
+    {NullS, NullS, SHOW_LONG, SHOW_SCOPE_GLOBAL}};
+
+#define SDB_LATENCY_BUCKET_NUM 40
+#define SDB_LATENCY_SHARD_NUM 16
+
+/*
+  Bucket 0 holds the latencies of 0us, bucket i holds [2^(i-1), 2^i) us.
+  The last one holds all the larger ones.
+*/
+struct Sdb_latency_hist {
+  volatile int64 buckets[SDB_LATENCY_BUCKET_NUM];
+  volatile int64 total;
+  volatile int64 max;
+  char pad[CPU_LEVEL1_DCACHE_LINESIZE];
+};
+
+static Sdb_latency_hist
+    sdb_rpc_latency[SDB_LATENCY_SHARD_NUM][SDB_RPC_OP_NUM];
+
+static const char *SDB_RPC_OP_NAMES[SDB_RPC_OP_NUM] = {
+    "query",       "query_one",    "fetch",         "insert",
+    "bulk_insert", "update",       "upsert",        "delete",
+    "count",       "exec",         "ddl",           "trans_begin",
+    "trans_commit", "trans_rollback"};
+
+const char *sdb_rpc_op_name(SDB_RPC_OP op) {
+  return SDB_RPC_OP_NAMES[op];
+}
+
+void sdb_rpc_latency_add(my_thread_id tid, SDB_RPC_OP op, ulonglong usec) {
+  Sdb_latency_hist &hist = sdb_rpc_latency[tid % SDB_LATENCY_SHARD_NUM][op];
+  uint i = 0;
+  for (ulonglong v = usec; v > 0 && i < SDB_LATENCY_BUCKET_NUM - 1; v >>= 1) {
+    ++i;
+  }
+  my_atomic_add64(&hist.buckets[i], 1);
+  my_atomic_add64(&hist.total, (int64)usec);
+
+  int64 old_max = my_atomic_load64(&hist.max);
+  while ((int64)usec > old_max &&
+         !my_atomic_cas64(&hist.max, &old_max, (int64)usec)) {
+  }
+}
+
+void sdb_rpc_latency_get(SDB_RPC_OP op, Sdb_latency_stat &stat) {
+  int64 buckets[SDB_LATENCY_BUCKET_NUM] = {0};
+  longlong calls = 0;
+
+  stat.total = 0;
+  stat.max = 0;
+  for (uint j = 0; j < SDB_LATENCY_SHARD_NUM; ++j) {
+    Sdb_latency_hist &hist = sdb_rpc_latency[j][op];
+    for (uint i = 0; i < SDB_LATENCY_BUCKET_NUM; ++i) {
+      buckets[i] += my_atomic_load64(&hist.buckets[i]);
+    }
+    stat.total += my_atomic_load64(&hist.total);
+    stat.max = MY_MAX(stat.max, my_atomic_load64(&hist.max));
+  }
+  for (uint i = 0; i < SDB_LATENCY_BUCKET_NUM; ++i) {
+    calls += buckets[i];
+  }
+  stat.calls = calls;
+
+  const double ratios[] = {0.50, 0.95, 0.99};
+  longlong *percentiles[] = {&stat.p50, &stat.p95, &stat.p99};
+  for (uint j = 0; j < array_elements(ratios); ++j) {
+    longlong rank = (longlong)(ratios[j] * calls + 0.5);
+    longlong count = 0;
+    uint i = 0;
+    for (; i < SDB_LATENCY_BUCKET_NUM - 1; ++i) {
+      count += buckets[i];
+      if (count >= rank) {
+        break;
+      }
+    }
+    longlong upper = (0 == i) ? 0 : (1LL << i) - 1;
+    *percentiles[j] = MY_MIN(upper, stat.max);
+  }
+}
+
+void sdb_rpc_latency_reset() {
+  for (uint j = 0; j < SDB_LATENCY_SHARD_NUM; ++j) {
+    for (uint op = 0; op < SDB_RPC_OP_NUM; ++op) {
+      Sdb_latency_hist &hist = sdb_rpc_latency[j][op];
+      for (uint i = 0; i < SDB_LATENCY_BUCKET_NUM; ++i) {
+        my_atomic_store64(&hist.buckets[i], 0);
+      }
+      my_atomic_store64(&hist.total, 0);
+      my_atomic_store64(&hist.max, 0);
+    }
+  }
+}
+
+static PSI_stage_info sdb_stage_querying = {0, "querying", 0};
+static PSI_stage_info sdb_stage_fetching = {0, "waiting for cursor batch", 0};
+static PSI_stage_info sdb_stage_inserting = {0, "inserting", 0};
+static PSI_stage_info sdb_stage_bulk_inserting = {0, "sending bulk insert", 0};
+static PSI_stage_info sdb_stage_updating = {0, "updating", 0};
+static PSI_stage_info sdb_stage_deleting = {0, "deleting", 0};
+static PSI_stage_info sdb_stage_ddl = {0, "altering collection", 0};
+static PSI_stage_info sdb_stage_beginning = {0, "beginning transaction", 0};
+static PSI_stage_info sdb_stage_committing = {0, "committing", 0};
+static PSI_stage_info sdb_stage_rolling_back = {0, "rolling back", 0};
+
+static PSI_stage_info *SDB_RPC_OP_STAGES[SDB_RPC_OP_NUM] = {
+    &sdb_stage_querying,        // query
+    &sdb_stage_querying,        // query_one
+    &sdb_stage_fetching,        // fetch
+    &sdb_stage_inserting,       // insert
+    &sdb_stage_bulk_inserting,  // bulk_insert
+    &sdb_stage_updating,        // update
+    &sdb_stage_updating,        // upsert
+    &sdb_stage_deleting,        // delete
+    &sdb_stage_querying,        // count
+    &sdb_stage_querying,        // exec
+    &sdb_stage_ddl,             // ddl
+    &sdb_stage_beginning,       // trans_begin
+    &sdb_stage_committing,      // trans_commit
+    &sdb_stage_rolling_back     // trans_rollback
+};
+
+#ifdef HAVE_PSI_INTERFACE
+static PSI_stage_info *all_sdb_stages[] = {
+    &sdb_stage_querying,  &sdb_stage_fetching,       &sdb_stage_inserting,
+    &sdb_stage_updating,  &sdb_stage_bulk_inserting, &sdb_stage_deleting,
+    &sdb_stage_ddl,       &sdb_stage_beginning,      &sdb_stage_committing,
+    &sdb_stage_rolling_back};
+
+void sdb_register_stages(const char *category) {
+  mysql_stage_register(category, all_sdb_stages,
+                       array_elements(all_sdb_stages));
+}
+#endif
+
+#define SDB_SLOW_OP_LOG_MAX_PER_SEC 10
+#define SDB_SLOW_OP_QUERY_MAX_LEN 512
+
+static volatile int64 sdb_slow_op_log_second = 0;
+static volatile int32 sdb_slow_op_log_count = 0;
+static volatile int64 sdb_slow_op_log_suppressed = 0;
+
+/*
+  At most SDB_SLOW_OP_LOG_MAX_PER_SEC slow operations are logged per second,
+  the others are only counted and reported with the next one logged.
+*/
+static bool sdb_slow_op_log_allowed(longlong &suppressed) {
+  int64 now = (int64)time(NULL);
+  int64 second = my_atomic_load64(&sdb_slow_op_log_second);
+  if (second != now &&
+      my_atomic_cas64(&sdb_slow_op_log_second, &second, now)) {
+    my_atomic_store32(&sdb_slow_op_log_count, 0);
+  }
+
+  if (my_atomic_add32(&sdb_slow_op_log_count, 1) >=
+      SDB_SLOW_OP_LOG_MAX_PER_SEC) {
+    my_atomic_add64(&sdb_slow_op_log_suppressed, 1);
+    return false;
+  }
+  suppressed = my_atomic_fas64(&sdb_slow_op_log_suppressed, 0);
+  return true;
+}
+
+Sdb_rpc_timer::Sdb_rpc_timer(SDB_RPC_OP op, Sdb_cl *cl,
+                             const bson::BSONObj *query, longlong rows)
+    : m_op(op), m_cl(cl), m_query(query), m_rows(rows), m_thd(current_thd) {
+  if (NULL != m_thd) {
+    m_thd->enter_stage(SDB_RPC_OP_STAGES[op], &m_old_stage, __func__,
+                       __FILE__, __LINE__);
+  }
+  m_start = my_micro_time();
+}
+
+Sdb_rpc_timer::~Sdb_rpc_timer() {
+  ulonglong elapsed = my_micro_time() - m_start;
+  my_thread_id tid = (NULL != m_thd) ? m_thd->thread_id() : 0;
+  sdb_rpc_latency_add(tid, m_op, elapsed);
+  if (sdb_slow_op_threshold > 0 &&
+      elapsed >= (ulonglong)sdb_slow_op_threshold * 1000) {
+    log_slow_op(elapsed);
+  }
+  if (NULL != m_thd) {
+    Thd_sdb *thd_sdb = thd_get_thd_sdb(m_thd);
+    if (NULL != thd_sdb) {
+      thd_sdb->add_stmt_rpc();
+    }
+  }
+  if (NULL != m_thd) {
+    m_thd->enter_stage(&m_old_stage, NULL, __func__, __FILE__, __LINE__);
+  }
+}
+
+void Sdb_rpc_timer::log_slow_op(ulonglong elapsed) {
+  my_thread_id tid = (NULL != m_thd) ? m_thd->thread_id() : 0;
+  longlong suppressed = 0;
+  std::string query;
+
+  sdb_stat_inc(tid, SDB_STAT_SLOW_OPS);
+  if (!sdb_slow_op_log_allowed(suppressed)) {
+    return;
+  }
+
+  if (NULL != m_query) {
+    query = m_query->toString();
+    if (query.length() > SDB_SLOW_OP_QUERY_MAX_LEN) {
+      query.resize(SDB_SLOW_OP_QUERY_MAX_LEN);
+      query.append("...");
+    }
+  }
+
+  SDB_LOG_WARNING(
+      "Slow operation[%s] took %llu us. collection[%s.%s], query[%s], "
+      "rows[%lld], thread[%u], %lld slow operations not logged before",
+      sdb_rpc_op_name(m_op), elapsed,
+      (NULL != m_cl) ? m_cl->get_cs_name() : "",
+      (NULL != m_cl) ? m_cl->get_cl_name() : "", query.c_str(), m_rows, tid,
+      suppressed);
+}
@@ -0,0 +1,139 @@
+/* Copyright (c) 2019, SequoiaDB and/or its affiliates. All rights reserved.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#ifndef SDB_STAT__H
+#define SDB_STAT__H
+
+#include <my_global.h>
+#include <my_thread_local.h>
+#include <my_sys.h>
+#include <mysql/plugin.h>
+#include <mysql/psi/mysql_stage.h>
+
+class THD;
+class Sdb_cl;
+namespace bson {
+class BSONObj;
+}
+
+enum SDB_STAT_COUNTER {
+  SDB_STAT_QUERIES = 0,
+  SDB_STAT_INSERTS,
+  SDB_STAT_BULK_INSERTS,
+  SDB_STAT_UPDATES,
+  SDB_STAT_DELETES,
+  SDB_STAT_TRANS_BEGINS,
+  SDB_STAT_TRANS_COMMITS,
+  SDB_STAT_TRANS_ROLLBACKS,
+  SDB_STAT_CURSOR_NEXTS,
+  SDB_STAT_ROWS_RECEIVED,
+  SDB_STAT_ROWS_SENT,
+  SDB_STAT_BYTES_RECEIVED,
+  SDB_STAT_BYTES_SENT,
+  SDB_STAT_RECONNECTS,
+  SDB_STAT_COND_PUSHED,
+  // a part of the condition is unsupported, so none of it is pushed down
+  SDB_STAT_COND_PART_UNSUPPORTED,
+  SDB_STAT_COND_NOT_PUSHED,
+  SDB_STAT_STATS_REFRESHES,
+  SDB_STAT_SLOW_OPS,
+  SDB_STAT_COUNTER_NUM
+};
+
+/*
+  The counters are sharded by thread id, so that the threads updating them
+  seldom touch the same cache line. They are summed up when being shown.
+*/
+void sdb_stat_add(my_thread_id tid, SDB_STAT_COUNTER counter, longlong value);
+
+inline void sdb_stat_inc(my_thread_id tid, SDB_STAT_COUNTER counter) {
+  sdb_stat_add(tid, counter, 1);
+}
+
+extern SHOW_VAR sdb_status_vars[];
+
+enum SDB_RPC_OP {
+  SDB_RPC_QUERY = 0,
+  SDB_RPC_QUERY_ONE,
+  SDB_RPC_FETCH,
+  SDB_RPC_INSERT,
+  SDB_RPC_BULK_INSERT,
+  SDB_RPC_UPDATE,
+  SDB_RPC_UPSERT,
+  SDB_RPC_DELETE,
+  SDB_RPC_COUNT,
+  SDB_RPC_EXEC,
+  SDB_RPC_DDL,
+  SDB_RPC_TRANS_BEGIN,
+  SDB_RPC_TRANS_COMMIT,
+  SDB_RPC_TRANS_ROLLBACK,
+  SDB_RPC_OP_NUM
+};
+
+// Latency summary of one kind of operation, in microseconds.
+struct Sdb_latency_stat {
+  longlong calls;
+  longlong total;
+  longlong p50;
+  longlong p95;
+  longlong p99;
+  longlong max;
+};
+
+const char *sdb_rpc_op_name(SDB_RPC_OP op);
+
+/*
+  The latencies are kept in log2 buckets without lock, so the percentiles
+  are the upper bounds of the buckets where they fall in. Like the counters,
+  the buckets are sharded by thread id.
+*/
+void sdb_rpc_latency_add(my_thread_id tid, SDB_RPC_OP op, ulonglong usec);
+
+void sdb_rpc_latency_get(SDB_RPC_OP op, Sdb_latency_stat &stat);
+
+void sdb_rpc_latency_reset();
+
+#ifdef HAVE_PSI_INTERFACE
+void sdb_register_stages(const char *category);
+#endif
+
+/*
+  Record the latency of the driver call in the scope. The thread stays in
+  the stage of the operation during the call, so that performance_schema
+  can tell the time spent on SequoiaDB. The calls slower than
+  sequoiadb_slow_op_threshold are logged with the collection, the query
+  and the rows.
+*/
+class Sdb_rpc_timer {
+ public:
+  Sdb_rpc_timer(SDB_RPC_OP op, Sdb_cl *cl = NULL,
+                const bson::BSONObj *query = NULL, longlong rows = -1);
+
+  ~Sdb_rpc_timer();
+
+ private:
+  void log_slow_op(ulonglong elapsed);
+
+ private:
+  SDB_RPC_OP m_op;
+  Sdb_cl *m_cl;
+  const bson::BSONObj *m_query;
+  longlong m_rows;
+  THD *m_thd;
+  PSI_stage_info m_old_stage;
+  ulonglong m_start;
+};
+
+#endif /* SDB_STAT__H */
@@ -20,21 +20,65 @@
 #include <my_global.h>
 #include <sql_class.h>
 #include <my_base.h>
+#include <my_atomic.h>
 #include "sdb_thd.h"
 #include "sdb_log.h"
 #include "sdb_errcode.h"
+#include "sdb_lock.h"
+#include "sdb_conf.h"
+
+static Sdb_mutex sdb_thd_list_mutex;
+static Thd_sdb* sdb_thd_list = NULL;
+
+void sdb_get_conn_infos(std::vector<Sdb_conn_info>& infos) {
+  Sdb_mutex_guard guard(sdb_thd_list_mutex);
+  for (Thd_sdb* thd_sdb = sdb_thd_list; thd_sdb != NULL;
+       thd_sdb = thd_sdb->m_next) {
+    Sdb_conn_info info;
+    info.thread_id = thd_sdb->m_thread_id;
+    info.slave_thread = thd_sdb->m_slave_thread;
+    info.transaction_on = thd_sdb->m_conn.is_transaction_on();
+    info.lock_count = my_atomic_load32(&thd_sdb->lock_count);
+    info.start_stmt_count = my_atomic_load32(&thd_sdb->start_stmt_count);
+    info.save_point_count = my_atomic_load32(&thd_sdb->save_point_count);
+    infos.push_back(info);
+  }
+}
 
 Thd_sdb::Thd_sdb(THD* thd)
     : m_thd(thd),
       m_slave_thread(thd->slave_thread),
-      m_conn(thd_get_thread_id(thd)) {
+      m_conn(thd_get_thread_id(thd)),
+      m_trace_query_id(0),
+      m_stmt_query_id(0),
+      m_stmt_rpcs(0),
+      m_stmt_rows(0),
+      m_prev(NULL),
+      m_next(NULL) {
   m_thread_id = thd_get_thread_id(thd);
   lock_count = 0;
   start_stmt_count = 0;
   save_point_count = 0;
+
+  Sdb_mutex_guard guard(sdb_thd_list_mutex);
+  m_next = sdb_thd_list;
+  if (NULL != sdb_thd_list) {
+    sdb_thd_list->m_prev = this;
+  }
+  sdb_thd_list = this;
 }
 
-Thd_sdb::~Thd_sdb() {}
+Thd_sdb::~Thd_sdb() {
+  Sdb_mutex_guard guard(sdb_thd_list_mutex);
+  if (NULL != m_prev) {
+    m_prev->m_next = m_next;
+  } else {
+    sdb_thd_list = m_next;
+  }
+  if (NULL != m_next) {
+    m_next->m_prev = m_prev;
+  }
+}
 
 Thd_sdb* Thd_sdb::seize(THD* thd) {
   Thd_sdb* thd_sdb = new (std::nothrow) Thd_sdb(thd);
@@ -49,6 +93,69 @@ void Thd_sdb::release(Thd_sdb* thd_sdb) {
   delete thd_sdb;
 }
 
+Sdb_query_trace* Thd_sdb::get_query_trace(const void* owner,
+                                          const char* db_name,
+                                          const char* table_name) {
+  if (m_trace_query_id != m_thd->query_id) {
+    m_query_traces.clear();
+    m_trace_query_id = m_thd->query_id;
+  }
+
+  for (std::vector<Sdb_query_trace>::iterator it = m_query_traces.begin();
+       it != m_query_traces.end(); ++it) {
+    if (it->owner == owner) {
+      return &(*it);
+    }
+  }
+
+  Sdb_query_trace trace;
+  trace.owner = owner;
+  trace.table_name.append(db_name).append(".").append(table_name);
+  trace.pushdown = "NONE";
+  trace.operation = "";
+  trace.calls = 0;
+  trace.skip = 0;
+  trace.limit = -1;
+  trace.flag = 0;
+  m_query_traces.push_back(trace);
+  return &m_query_traces.back();
+}
+
+void Thd_sdb::switch_stmt() {
+  if (m_stmt_query_id != m_thd->query_id) {
+    m_stmt_query_id = m_thd->query_id;
+    m_stmt_rpcs = 0;
+    m_stmt_rows = 0;
+  }
+}
+
+void Thd_sdb::add_stmt_rpc() {
+  switch_stmt();
+  ++m_stmt_rpcs;
+
+  uint threshold = sdb_stmt_rpc_warn_threshold(m_thd);
+  if (threshold > 0 && m_stmt_rpcs == (ulonglong)threshold + 1) {
+    push_warning_printf(m_thd, Sql_condition::SL_WARNING, ER_UNKNOWN_ERROR,
+                        "SequoiaDB: the statement sends more than %u "
+                        "requests to SequoiaDB "
+                        "(sequoiadb_stmt_rpc_warn_threshold)",
+                        threshold);
+  }
+}
+
+void Thd_sdb::add_stmt_rows(ulonglong rows) {
+  switch_stmt();
+  m_stmt_rows += rows;
+}
+
+void sdb_stmt_add_rows(ulonglong rows) {
+  THD* thd = current_thd;
+  Thd_sdb* thd_sdb = (NULL != thd) ? thd_get_thd_sdb(thd) : NULL;
+  if (NULL != thd_sdb) {
+    thd_sdb->add_stmt_rows(rows);
+  }
+}
+
 bool Thd_sdb::recycle_conn() {
   int rc = SDB_ERR_OK;
   rc = m_conn.connect();
@@ -18,10 +18,44 @@
 
 #include <mysql/plugin.h>
 #include <client.hpp>
+#include <vector>
+#include <string>
 #include "sdb_conn.h"
 
 extern handlerton* sdb_hton;
 
+// A connection shown in INFORMATION_SCHEMA.SEQUOIADB_CONNECTIONS.
+struct Sdb_conn_info {
+  my_thread_id thread_id;
+  bool slave_thread;
+  bool transaction_on;
+  uint lock_count;
+  uint start_stmt_count;
+  uint save_point_count;
+};
+
+// Copy the infos of all the Thd_sdb alive.
+void sdb_get_conn_infos(std::vector<Sdb_conn_info>& infos);
+
+/*
+  The last query sent by a handler in the last statement, shown in
+  INFORMATION_SCHEMA.SEQUOIADB_PUSHED_QUERIES.
+*/
+struct Sdb_query_trace {
+  const void* owner;
+  std::string table_name;
+  const char* pushdown;
+  const char* operation;
+  ulonglong calls;
+  bson::BSONObj condition;
+  bson::BSONObj selector;
+  bson::BSONObj order_by;
+  bson::BSONObj hint;
+  longlong skip;
+  longlong limit;
+  int flag;
+};
+
 class Thd_sdb {
  private:
   Thd_sdb(THD* thd);
@@ -37,15 +71,46 @@ class Thd_sdb {
   inline Sdb_conn* get_conn() { return &m_conn; }
   inline bool valid_conn() { return m_conn.is_valid(); }
 
-  uint lock_count;
-  uint start_stmt_count;
-  uint save_point_count;
+  // Get the trace of the handler, the traces of the previous statement are
+  // dropped first.
+  Sdb_query_trace* get_query_trace(const void* owner, const char* db_name,
+                                   const char* table_name);
+  inline std::vector<Sdb_query_trace>& get_query_traces() {
+    return m_query_traces;
+  }
+
+  // Count the requests and rows of the current statement. A warning is
+  // raised once when sequoiadb_stmt_rpc_warn_threshold is exceeded.
+  void add_stmt_rpc();
+  void add_stmt_rows(ulonglong rows);
+  inline ulonglong stmt_rpcs() const { return m_stmt_rpcs; }
+  inline ulonglong stmt_rows() const { return m_stmt_rows; }
+
+  // Read by sdb_get_conn_infos() in other threads, so they are changed by
+  // my_atomic_*().
+  volatile int32 lock_count;
+  volatile int32 start_stmt_count;
+  volatile int32 save_point_count;
+
+ private:
+  void switch_stmt();
 
  private:
   THD* m_thd;
   my_thread_id m_thread_id;
   const bool m_slave_thread;  // cached value of m_thd->slave_thread
   Sdb_conn m_conn;
+  longlong m_trace_query_id;
+  std::vector<Sdb_query_trace> m_query_traces;
+  longlong m_stmt_query_id;
+  ulonglong m_stmt_rpcs;
+  ulonglong m_stmt_rows;
+
+  // list of all the Thd_sdb alive
+  Thd_sdb* m_prev;
+  Thd_sdb* m_next;
+
+  friend void sdb_get_conn_infos(std::vector<Sdb_conn_info>& infos);
 };
 
 // Set Thd_sdb pointer for THD
@@ -58,6 +123,9 @@ static inline Thd_sdb* thd_get_thd_sdb(THD* thd) {
   return (Thd_sdb*)thd_get_ha_data(thd, sdb_hton);
 }
 
+// Count the rows transferred by the current statement of the thread.
+void sdb_stmt_add_rows(ulonglong rows);
+
 // Make sure THD has a Thd_sdb struct assigned
 Sdb_conn* check_sdb_in_thd(THD* thd, bool validate_conn = false);
 
@@ -0,0 +1,162 @@
+#!/bin/bash
+#
+# End-to-end benchmark of the sequoiadb engine, driven by sysbench.
+#
+# Each workload runs against the mysqld given by MYSQL_HOST/MYSQL_PORT. The
+# Sequoiadb_* counters are sampled before and after the run, and the
+# SEQUOIADB_RPC_LATENCY histograms are reset before it, so every result only
+# covers its own workload. The results go to $OUT_DIR:
+#
+#   <workload>.sysbench.txt  the sysbench report
+#   <workload>.status.tsv    deltas of the Sequoiadb_* counters
+#   <workload>.latency.tsv   SEQUOIADB_RPC_LATENCY after the run
+#   summary.tsv              one line per workload
+#
+# Usage:
+#   MYSQL_HOST=127.0.0.1 MYSQL_PORT=3306 tools/sdb_bench.sh [workload ...]
+#
+# Workloads: point_select range_select update_pk insert mixed delete_range
+#            bulk_insert. All of them are run by default. bulk_insert always
+#            runs last, on its own tables.
+#
+# With a debug build of the engine, RPC_DELAY_US sets
+# sequoiadb_debug_rpc_delay and the debug keyword sdb_rpc_delay to simulate
+# a remote coordinator.
+
+set -eu
+export LC_ALL=C
+
+MYSQL_HOST=${MYSQL_HOST:-127.0.0.1}
+MYSQL_PORT=${MYSQL_PORT:-3306}
+MYSQL_USER=${MYSQL_USER:-root}
+MYSQL_PASSWORD=${MYSQL_PASSWORD:-}
+MYSQL_DB=${MYSQL_DB:-sbtest}
+TABLES=${TABLES:-4}
+TABLE_SIZE=${TABLE_SIZE:-100000}
+THREADS=${THREADS:-16}
+TIME=${TIME:-60}
+RPC_DELAY_US=${RPC_DELAY_US:-}
+OUT_DIR=${OUT_DIR:-sdb_bench_$(date +%Y%m%d_%H%M%S)}
+
+TOOLS_DIR=$(cd "$(dirname "$0")" && pwd)
+WORKLOADS=${*:-point_select range_select update_pk insert mixed delete_range \
+bulk_insert}
+
+MYSQL="mysql -h$MYSQL_HOST -P$MYSQL_PORT -u$MYSQL_USER"
+SYSBENCH="sysbench --db-driver=mysql --mysql-host=$MYSQL_HOST \
+--mysql-port=$MYSQL_PORT --mysql-user=$MYSQL_USER --mysql-db=$MYSQL_DB \
+--mysql-storage-engine=sequoiadb --tables=$TABLES --table-size=$TABLE_SIZE"
+if [ -n "$MYSQL_PASSWORD" ]; then
+  export MYSQL_PWD=$MYSQL_PASSWORD
+  SYSBENCH="$SYSBENCH --mysql-password=$MYSQL_PASSWORD"
+fi
+
+sql() {
+  $MYSQL -N -B -e "$1"
+}
+
+# Prints "name<TAB>value" of the global Sequoiadb_* counters.
+status() {
+  sql "SHOW GLOBAL STATUS LIKE 'Sequoiadb\_%'" | sort
+}
+
+# Prints the value of a "<name>: <n> (...)" line of the sysbench report.
+report_value() {
+  awk -v key="$2:" '$1 == key { print $2; exit }' "$1"
+}
+
+run_workload() {
+  local name=$1
+  shift
+  local before=$OUT_DIR/$name.status.before
+
+  status >"$before"
+  sql "SET GLOBAL sequoiadb_rpc_latency_reset = ON"
+  $SYSBENCH --threads=$THREADS --time=$TIME --report-interval=10 \
+    --percentile=99 "$@" run >"$OUT_DIR/$name.sysbench.txt"
+
+  status | join -t "$(printf '\t')" "$before" - |
+    awk -F '\t' '{ printf "%s\t%d\n", $1, $3 - $2 }' \
+      >"$OUT_DIR/$name.status.tsv"
+  rm -f "$before"
+  sql "SELECT * FROM INFORMATION_SCHEMA.SEQUOIADB_RPC_LATENCY
+       WHERE CALLS > 0" >"$OUT_DIR/$name.latency.tsv"
+
+  local report=$OUT_DIR/$name.sysbench.txt
+  local queries=$(report_value "$report" queries)
+  local rpcs=$(awk -F '\t' '{ sum += $2 } END { print sum + 0 }' \
+    "$OUT_DIR/$name.latency.tsv")
+  printf "%s\t%s\t%s\t%s\t%s\t%s\t%s\n" "$name" \
+    "$(grep -o 'transactions: *[0-9]* *([0-9.]*' "$report" |
+      sed 's/.*(//')" \
+    "$(grep -o 'queries: *[0-9]* *([0-9.]*' "$report" | sed 's/.*(//')" \
+    "$(report_value "$report" avg)" \
+    "$(awk '$1 == "99th" { print $3; exit }' "$report")" \
+    "$rpcs" \
+    "$(awk -v r="$rpcs" -v q="$queries" \
+      'BEGIN { printf "%.2f", q > 0 ? r / q : 0 }')" \
+    >>"$OUT_DIR/summary.tsv"
+}
+
+mkdir -p "$OUT_DIR"
+printf "workload\ttps\tqps\tavg_ms\tp99_ms\trpcs\trpcs_per_query\n" \
+  >"$OUT_DIR/summary.tsv"
+
+sql "CREATE DATABASE IF NOT EXISTS $MYSQL_DB"
+if [ -n "$RPC_DELAY_US" ]; then
+  sql "SET GLOBAL sequoiadb_debug_rpc_delay = $RPC_DELAY_US"
+  sql "SET GLOBAL debug = '+d,sdb_rpc_delay'"
+fi
+
+$SYSBENCH --threads=$THREADS oltp_read_write prepare >/dev/null
+
+bulk_insert=
+for workload in $WORKLOADS; do
+  if [ "$workload" = bulk_insert ]; then
+    bulk_insert=1
+    continue
+  fi
+  echo "running $workload"
+  case $workload in
+    point_select)
+      run_workload $workload oltp_point_select
+      ;;
+    range_select)
+      run_workload $workload oltp_read_only --point-selects=0 \
+        --simple-ranges=1 --sum-ranges=1 --order-ranges=1 \
+        --distinct-ranges=1
+      ;;
+    update_pk)
+      run_workload $workload oltp_update_non_index
+      ;;
+    insert)
+      run_workload $workload oltp_insert
+      ;;
+    mixed)
+      run_workload $workload oltp_read_write
+      ;;
+    delete_range)
+      run_workload $workload "$TOOLS_DIR/sdb_bench_delete_range.lua"
+      ;;
+    *)
+      echo "unknown workload: $workload" >&2
+      exit 1
+      ;;
+  esac
+done
+
+$SYSBENCH oltp_read_write cleanup >/dev/null
+
+# The prepare command of bulk_insert doesn't give the engine, so its tables
+# are created here.
+if [ -n "$bulk_insert" ]; then
+  echo "running bulk_insert"
+  for i in $(seq 1 $THREADS); do
+    sql "CREATE TABLE $MYSQL_DB.sbtest$i (id INTEGER NOT NULL,
+         k INTEGER DEFAULT '0' NOT NULL, PRIMARY KEY (id)) ENGINE=sequoiadb"
+  done
+  run_workload bulk_insert bulk_insert
+  $SYSBENCH --threads=$THREADS bulk_insert cleanup >/dev/null
+fi
+
+column -t "$OUT_DIR/summary.tsv"
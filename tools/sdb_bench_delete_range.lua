@@ -0,0 +1,14 @@
+-- Deletes a range of --range-size rows by the primary key in each event.
+-- It's used by sdb_bench.sh, and needs the tables of oltp_common.
+
+require("oltp_common")
+
+function prepare_statements()
+end
+
+function event()
+  local tnum = sysbench.rand.uniform(1, sysbench.opt.tables)
+  local id = sysbench.rand.default(1, sysbench.opt.table_size)
+  con:query(string.format("DELETE FROM sbtest%d WHERE id BETWEEN %d AND %d",
+                          tnum, id, id + sysbench.opt.range_size - 1))
+end
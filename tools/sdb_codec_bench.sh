@@ -0,0 +1,178 @@
+#!/bin/bash
+#
+# Benchmark of the row codec and the condition builders of the sequoiadb
+# engine, run through a mysqld with a single connection.
+#
+# For each schema of the matrix, the phases are:
+#
+#   insert  INSERT ... SELECT of $ROWS rows, the row_to_obj() path
+#   scan    a full scan of all the columns which matches no row, the
+#           obj_to_row() path
+#   lookup  $ROWS lookups by the primary key, the key condition path
+#   cond    $STMTS statements with a pushed condition, the Sdb_cond_ctx path
+#
+# The time of the requests to SequoiaDB is taken from SEQUOIADB_RPC_LATENCY
+# and subtracted from the wall time, which leaves the time spent in mysqld.
+# The results are printed as TSV:
+#
+#   schema phase count wall_us rpc_us mysqld_us count_per_sec
+#
+# count_per_sec is computed from mysqld_us.
+#
+# Usage:
+#   MYSQL_HOST=127.0.0.1 MYSQL_PORT=3306 tools/sdb_codec_bench.sh [schema ...]
+#
+# Schemas: narrow_int wide_varchar decimal datetime blob json. All of them
+# are run by default. ROWS is at most 1000000.
+
+set -eu
+
+MYSQL_HOST=${MYSQL_HOST:-127.0.0.1}
+MYSQL_PORT=${MYSQL_PORT:-3306}
+MYSQL_USER=${MYSQL_USER:-root}
+MYSQL_DB=${MYSQL_DB:-sdb_codec_bench}
+ROWS=${ROWS:-100000}
+STMTS=${STMTS:-10000}
+SCHEMAS=${*:-narrow_int wide_varchar decimal datetime blob json}
+if [ -n "${MYSQL_PASSWORD:-}" ]; then
+  export MYSQL_PWD=$MYSQL_PASSWORD
+fi
+
+MYSQL="mysql -h$MYSQL_HOST -P$MYSQL_PORT -u$MYSQL_USER -N -B $MYSQL_DB"
+
+columns() {
+  case $1 in
+    narrow_int)
+      echo "a INT, b BIGINT, c SMALLINT, d TINYINT"
+      ;;
+    wide_varchar)
+      echo "a VARCHAR(1024), b VARCHAR(1024)"
+      ;;
+    decimal)
+      echo "a DECIMAL(20,6), b DECIMAL(38,10)"
+      ;;
+    datetime)
+      echo "a DATE, b DATETIME(6), c TIMESTAMP(6) NULL, d TIME"
+      ;;
+    blob)
+      echo "a BLOB, b TEXT"
+      ;;
+    json)
+      echo "a JSON"
+      ;;
+    *)
+      echo "unknown schema: $1" >&2
+      exit 1
+      ;;
+  esac
+}
+
+# The values of the columns for the row n.
+values() {
+  case $1 in
+    narrow_int)
+      echo "n, n * 1000, n % 30000, n % 100"
+      ;;
+    wide_varchar)
+      echo "REPEAT(MD5(n), 16), REPEAT(SHA1(n), 8)"
+      ;;
+    decimal)
+      echo "n / 7, n * 1234567.891"
+      ;;
+    datetime)
+      echo "'2000-01-01' + INTERVAL n DAY,
+            '2000-01-01' + INTERVAL n SECOND,
+            '2000-01-01' + INTERVAL n MICROSECOND,
+            SEC_TO_TIME(n % 86400)"
+      ;;
+    blob)
+      echo "REPEAT(MD5(n), 64), REPEAT(SHA1(n), 32)"
+      ;;
+    json)
+      echo "JSON_OBJECT('id', n, 'name', MD5(n),
+                        'tags', JSON_ARRAY(n % 10, n % 100))"
+      ;;
+  esac
+}
+
+# A condition which can be pushed down and matches no row.
+cond() {
+  case $1 in
+    narrow_int)
+      echo "a < 0 AND (b > $2 OR c IN (1, 2, 3)) AND d IS NOT NULL"
+      ;;
+    wide_varchar | blob)
+      echo "id < 0 AND (a = 'x$2' OR b LIKE 'y%') AND a IS NOT NULL"
+      ;;
+    decimal)
+      echo "id < 0 AND (a > $2.5 OR b BETWEEN 1 AND $2) AND a IS NOT NULL"
+      ;;
+    datetime)
+      echo "id < 0 AND (a > '2000-01-01' OR b < '2001-01-01') AND c IS NOT NULL"
+      ;;
+    json)
+      echo "id < 0 AND (id = $2 OR id IN (1, 2, 3)) AND a IS NOT NULL"
+      ;;
+  esac
+}
+
+now_us() {
+  echo $(($(date +%s%N) / 1000))
+}
+
+# Runs the statements from stdin, and prints the result line of the phase.
+run_phase() {
+  local schema=$1
+  local phase=$2
+  local count=$3
+
+  $MYSQL -e "SET GLOBAL sequoiadb_rpc_latency_reset = ON"
+  local start=$(now_us)
+  $MYSQL >/dev/null
+  local wall=$(($(now_us) - start))
+  local rpc=$($MYSQL -e "SELECT IFNULL(SUM(TOTAL_US), 0)
+                         FROM INFORMATION_SCHEMA.SEQUOIADB_RPC_LATENCY")
+  local mysqld=$((wall - rpc))
+  printf "%s\t%s\t%d\t%d\t%d\t%d\t%.0f\n" "$schema" "$phase" "$count" \
+    "$wall" "$rpc" "$mysqld" \
+    "$(awk -v c="$count" -v t="$mysqld" \
+      'BEGIN { print t > 0 ? c * 1000000 / t : 0 }')"
+}
+
+mysql -h$MYSQL_HOST -P$MYSQL_PORT -u$MYSQL_USER \
+  -e "CREATE DATABASE IF NOT EXISTS $MYSQL_DB"
+
+# seq holds 1..$ROWS, out of SequoiaDB, as the source of the rows.
+$MYSQL <<SQL
+DROP TABLE IF EXISTS digits, seq;
+CREATE TABLE digits (d INT) ENGINE=MEMORY;
+INSERT INTO digits VALUES (0), (1), (2), (3), (4), (5), (6), (7), (8), (9);
+CREATE TABLE seq (n INT PRIMARY KEY) ENGINE=MEMORY;
+INSERT INTO seq
+  SELECT d1.d + d2.d * 10 + d3.d * 100 + d4.d * 1000 + d5.d * 10000 +
+         d6.d * 100000 + 1 AS n
+  FROM digits d1, digits d2, digits d3, digits d4, digits d5, digits d6
+  HAVING n <= $ROWS;
+SQL
+
+printf "schema\tphase\tcount\twall_us\trpc_us\tmysqld_us\tcount_per_sec\n"
+for schema in $SCHEMAS; do
+  $MYSQL -e "DROP TABLE IF EXISTS t_$schema;
+             CREATE TABLE t_$schema (id INT PRIMARY KEY, $(columns $schema))
+             ENGINE=sequoiadb"
+
+  echo "INSERT INTO t_$schema SELECT n, $(values $schema) FROM seq" |
+    run_phase $schema insert $ROWS
+  # id + 0 isn't pushed down, so all the rows are read and filtered by mysqld
+  echo "SELECT * FROM t_$schema WHERE id + 0 < 0" |
+    run_phase $schema scan $ROWS
+  echo "SELECT STRAIGHT_JOIN COUNT(t.a) FROM seq JOIN t_$schema t
+        ON t.id = seq.n" | run_phase $schema lookup $ROWS
+  for i in $(seq 1 $STMTS); do
+    echo "SELECT id FROM t_$schema WHERE $(cond $schema $i);"
+  done | run_phase $schema cond $STMTS
+
+  $MYSQL -e "DROP TABLE t_$schema"
+done
+
+$MYSQL -e "DROP TABLE digits, seq"